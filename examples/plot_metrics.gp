@@ -0,0 +1,17 @@
+# Live plot of the metrics bhm_snake appends to its metrics file, reloaded every second.
+# Usage: gnuplot -c plot_metrics.gp [metrics file, out/metrics.csv by default]
+
+metrics_file = ARGC > 0 ? ARG1 : "out/metrics.csv"
+
+set datafile separator ","
+set title "Cortex fitness"
+set xlabel "Generation"
+set ylabel "Fitness"
+set key top left
+
+while (1) {
+   plot metrics_file using 1:($3 - $4):($3 + $4) every ::1 with filledcurves fillstyle transparent solid 0.2 title "mean +- stddev", \
+      "" using 1:3 every ::1 with lines title "mean", \
+      "" using 1:2 every ::1 with lines title "best"
+   pause 1
+}
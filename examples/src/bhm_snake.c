@@ -1,22 +1,81 @@
 // #define GRAPHICS
 #define PLOT
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
 #include <getopt.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
 #include <snaken/snaken.h>
+#include <snaken/utils.h>
 #include <behema/behema.h>
 
 #ifdef GRAPHICS
 #include "draw_snaken.h"
 #include "draw_cortex.h"
+#include "triple_buffer.h"
 #endif
 
 #define POP_SIZE 20
 #define MAX_EVAL_TIME 10000
 #define GENERATIONS_COUNT 10000
 
+// 0 means one evaluation worker per online processor.
+#define EVAL_THREADS_COUNT 0
+
+// Number of episodes, each on its own seed, every cortex is evaluated on.
+#define EVAL_SEEDS_COUNT 4
+
+// Number of generations evaluated on the same seeds, whose fitness can therefore be cached.
+#define REEVAL_INTERVAL 10
+
+// Whether to drop evaluations as soon as they cannot make it into the selection pool anymore.
+#define EVAL_PRUNING 1
+
+// Number of steps between two checks of whether an evaluation can still make it into the selection pool.
+#define EVAL_BOUND_INTERVAL 64
+
+// Number of generations between two population checkpoints, 0 to only checkpoint when the best fitness improves.
+#define CHECKPOINT_INTERVAL 10
+
+// Whether to also checkpoint the population whenever the best fitness improves.
+#define CHECKPOINT_ON_BEST 1
+
+// Number of checkpoint files to keep, older ones being deleted, 0 to keep all of them.
+#define CHECKPOINT_KEEP_COUNT 5
+
+#define CHECKPOINT_NAME_LENGTH 100
+
+#define METRICS_FILE_NAME "out/metrics.csv"
+
+// Number of metrics records evolution can get ahead of the metrics writer by.
+#define METRICS_QUEUE_LENGTH 1024
+
+// Time between two writes of the metrics writer.
+#define METRICS_WRITE_PERIOD_MS 200
+
+// Number of episodes every cortex is scored on when running saved cortices.
+#define RUN_SEEDS_COUNT 100
+
+// Seed the scoring seeds are derived from, fixed so that scores from separate runs stay comparable.
+#define RUN_SEED 0
+
+#define RUN_RESULTS_FILE_NAME "out/run.csv"
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325u
+#define FNV_PRIME 0x100000001B3u
+
 #define WORLD_WIDTH 30
 #define WORLD_HEIGHT 30
+#define SNAKE_LENGTH 0xFFu
 
 #define CORTICES_WIDTH 20
 #define CORTICES_HEIGHT 4
@@ -26,6 +85,12 @@
 #ifdef GRAPHICS
 #define WINDOW_WIDTH WORLD_WIDTH * 20
 #define WINDOW_HEIGHT WORLD_HEIGHT * 20
+
+// Rate episodes are drawn at, independently from the rate they run at.
+#define DISPLAY_FPS 60
+
+// Rate replayed episodes run at, so that they can be followed.
+#define REPLAY_STEPS_PER_SECOND 60
 #endif
 
 int clamp(int d, int min, int max) {
@@ -70,7 +135,7 @@ snaken_error_code_t create_snaken(
       return snaken_error;
    }
 
-   snaken_error = snaken2d_set_snake_length(*snaken, 0xFFu);
+   snaken_error = snaken2d_set_snake_length(*snaken, SNAKE_LENGTH);
    if (snaken_error != SNAKEN_ERROR_NONE) {
       printf("There was an error updating the snake length: %d\n", snaken_error);
       return snaken_error;
@@ -109,46 +174,234 @@ snaken_error_code_t create_snaken(
    return SNAKEN_ERROR_NONE;
 }
 
-/// @brief Evaluates the provided cortex.
-/// @param cortex The cortex to evaluate.
-/// @param fitness The cortex fitness score as a result of the evaluation process.
+#ifdef GRAPHICS
+/// @brief State of an episode at a given step, as published for the viewer.
+typedef struct {
+   snaken_frame_t world;
+   bhm_cortex2d_t* cortex;
+} episode_snapshot_t;
+
+/// @brief Latest steps published by a single evaluation context.
+typedef struct {
+   episode_snapshot_t snapshots[3];
+   triple_buffer_t buffer;
+} viewer_channel_t;
+
+/// @brief Shows the episodes run by evaluation contexts from the main thread, which is the only one allowed to draw.
+/// Every context publishes a snapshot to a channel of its own after every step and the viewer draws the latest ones at display rate,
+/// so that watching never slows evaluation down.
+/// A single channel is drawn along with its cortex, while many channels are drawn as a mosaic of their worlds.
+typedef struct {
+   viewer_channel_t* channels;
+   int channels_count;
+
+   snaken_renderer_t snaken_renderer;
+   cortex_renderer_t cortex_renderer;
+   snaken_mosaic_t mosaic;
+
+   // Worlds drawn by the mosaic, one per channel.
+   snaken_frame_t** frames;
+
+   // Whether the window was closed, after which snapshots are not published anymore.
+   _Atomic bhm_bool_t closed;
+} viewer_t;
+
+/// @brief Initializes the provided viewer for episodes of cortices shaped like the provided one.
+/// @param viewer The viewer to initialize.
+/// @param cortex A cortex with the same shape as the ones to show.
+/// @param channels_count The number of contexts publishing to the viewer.
 /// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
-bhm_error_code_t eval_cortex(
-   bhm_cortex2d_t* cortex,
-   bhm_cortex_fitness_t* fitness
-) {
-   // ##########################################
-   // Init cortices.
-   // ##########################################
+bhm_error_code_t viewer_init(viewer_t* viewer, bhm_cortex2d_t* cortex, int channels_count) {
    bhm_error_code_t bhm_error;
 
-   bhm_cortex2d_t* tmp_cortex;
-   bhm_error = c2d_create(&tmp_cortex, cortex->width, cortex->height, cortex->nh_radius);
-   if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error creating cortex %d\n", bhm_error);
-      return bhm_error;
+   viewer->channels_count = channels_count;
+   viewer->channels = (viewer_channel_t*) malloc(channels_count * sizeof(viewer_channel_t));
+   viewer->frames = (snaken_frame_t**) malloc(channels_count * sizeof(snaken_frame_t*));
+   if (viewer->channels == NULL || viewer->frames == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
    }
-   bhm_error = c2d_copy(tmp_cortex, cortex);
-   if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error copying cortex %d\n", bhm_error);
-      return bhm_error;
+
+   for (int c = 0; c < channels_count; c++) {
+      viewer_channel_t* channel = &(viewer->channels[c]);
+
+      for (int i = 0; i < 3; i++) {
+         snaken_error_code_t snaken_error = snaken_frame_init(&(channel->snapshots[i].world), WORLD_WIDTH, WORLD_HEIGHT);
+         if (snaken_error != SNAKEN_ERROR_NONE) {
+            printf("There was an error initializing the snapshot world: %d\n", snaken_error);
+            return BHM_ERROR_EXTERNAL_CAUSES;
+         }
+
+         // Every snapshot is readable right away, the viewer drawing empty episodes until the first one is published.
+         // Cortices are only ever drawn for a single channel, so mosaics skip them altogether.
+         channel->snapshots[i].cortex = NULL;
+         if (channels_count == 1) {
+            bhm_error = c2d_create(&(channel->snapshots[i].cortex), cortex->width, cortex->height, cortex->nh_radius);
+            if (bhm_error != BHM_ERROR_NONE) {
+               printf("There was an error creating the snapshot cortex: %d\n", bhm_error);
+               return bhm_error;
+            }
+         }
+      }
+      triple_buffer_init(&(channel->buffer), &(channel->snapshots[0]), &(channel->snapshots[1]), &(channel->snapshots[2]));
    }
 
-   bhm_cortex_counts_t* counts = (bhm_cortex_counts_t*) malloc(sizeof(bhm_cortex_counts_t));
-   counts->ticks_count = 0x00;
-   counts->evols_count = 0x00;
-   // ##########################################
-   // ##########################################
+   snaken_renderer_init(&(viewer->snaken_renderer));
+   cortex_renderer_init(&(viewer->cortex_renderer));
+   snaken_mosaic_init(&(viewer->mosaic));
+   atomic_init(&(viewer->closed), BHM_FALSE);
 
+   return BHM_ERROR_NONE;
+}
 
-   // ##########################################
-   // Init snaken.
-   // ##########################################
-   snaken_error_code_t snaken_error;
+/// @brief Publishes the current step of an episode to the provided viewer channel, unless the viewer was closed.
+/// @param viewer The viewer to publish to.
+/// @param channel The channel of the publishing context.
+/// @param snaken The world of the episode.
+/// @param cortex The cortex playing the episode.
+/// @param episode The number of the episode in the publishing context.
+/// @return Whether the step was published.
+bhm_bool_t viewer_publish(
+   viewer_t* viewer,
+   int channel,
+   snaken2d_t* snaken,
+   bhm_cortex2d_t* cortex,
+   uint64_t episode
+) {
+   if (atomic_load(&(viewer->closed))) return BHM_FALSE;
+
+   triple_buffer_t* buffer = &(viewer->channels[channel].buffer);
+   episode_snapshot_t* snapshot = (episode_snapshot_t*) triple_buffer_back(buffer);
+   snaken_frame_capture(&(snapshot->world), snaken, &(viewer->snaken_renderer.palette));
+   snapshot->world.episode = episode;
+   if (snapshot->cortex != NULL) c2d_copy(snapshot->cortex, cortex);
+   triple_buffer_publish(buffer);
+
+   return BHM_TRUE;
+}
+
+/// @brief Draws the latest snapshots published to the provided viewer.
+/// @param viewer The viewer to draw.
+void viewer_draw(viewer_t* viewer) {
+   BeginDrawing();
+      ClearBackground(BLACK);
+      if (viewer->channels_count == 1) {
+         episode_snapshot_t* snapshot = (episode_snapshot_t*) triple_buffer_front(&(viewer->channels[0].buffer));
+         draw_snaken_frame(
+            &(viewer->snaken_renderer),
+            &(snapshot->world),
+            WINDOW_WIDTH,
+            WINDOW_HEIGHT
+         );
+         draw_cortex(
+            &(viewer->cortex_renderer),
+            snapshot->cortex,
+            WINDOW_WIDTH,
+            WINDOW_HEIGHT
+         );
+      } else {
+         for (int c = 0; c < viewer->channels_count; c++) {
+            episode_snapshot_t* snapshot = (episode_snapshot_t*) triple_buffer_front(&(viewer->channels[c].buffer));
+            viewer->frames[c] = &(snapshot->world);
+         }
+         draw_snaken_mosaic(
+            &(viewer->mosaic),
+            viewer->frames,
+            viewer->channels_count,
+            WINDOW_WIDTH,
+            WINDOW_HEIGHT
+         );
+      }
+   EndDrawing();
+}
+
+/// @brief Stops publishing snapshots to the provided viewer and releases its textures. Must be called before closing the window.
+/// @param viewer The viewer to close.
+void viewer_close(viewer_t* viewer) {
+   atomic_store(&(viewer->closed), BHM_TRUE);
+   snaken_renderer_destroy(&(viewer->snaken_renderer));
+   cortex_renderer_destroy(&(viewer->cortex_renderer));
+   snaken_mosaic_destroy(&(viewer->mosaic));
+}
+
+/// @brief Destroys the snapshots of the provided viewer, once no context publishes to it anymore.
+/// @param viewer The viewer to destroy.
+void viewer_destroy(viewer_t* viewer) {
+   for (int c = 0; c < viewer->channels_count; c++) {
+      for (int i = 0; i < 3; i++) {
+         snaken_frame_destroy(&(viewer->channels[c].snapshots[i].world));
+         if (viewer->channels[c].snapshots[i].cortex != NULL) c2d_destroy(viewer->channels[c].snapshots[i].cortex);
+      }
+   }
+   free(viewer->channels);
+   free(viewer->frames);
+}
+#endif
+
+/// @brief Everything needed to evaluate cortices, allocated once and reused across evaluations.
+typedef struct {
+   // Scratch copies of the evaluated cortex, ticked back and forth so that the evaluated cortex itself is left untouched.
+   // Evaluations are then only a function of cortex and seed, which is what makes their results cacheable.
+   bhm_cortex2d_t* cortices[2];
+
+   bhm_input2d_t* input;
+   bhm_cortex_size_t input_width;
+   bhm_output2d_t* left_output;
+   bhm_output2d_t* right_output;
+
+   // World evaluations run in, reset at the start of each of them.
+   snaken2d_t* snaken;
+   snaken_cell_type_t* snake_view;
+
+   int max_eval_time;
+
+   // Number of steps run by the context since last collected.
+   uint64_t ticks_count;
+
+   #ifdef GRAPHICS
+   // Viewer every step is published to, NULL for none, and channel of the viewer reserved to the context.
+   // Only ever set while the context is not evaluating.
+   viewer_t* viewer;
+   int viewer_channel;
+
+   // Number of episodes run by the context, so that the viewer can tell resets apart.
+   uint64_t episodes_count;
+
+   // Minimum time between two published steps in ns, 0 for none.
+   long step_period;
+   #endif
+} eval_context_t;
+
+/// @brief Initializes the provided evaluation context for cortices shaped like the provided one.
+/// @param context The context to initialize.
+/// @param cortex A cortex with the same shape as the ones to evaluate.
+/// @param max_eval_time The maximum number of steps each evaluation can take.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_context_init(
+   eval_context_t* context,
+   bhm_cortex2d_t* cortex,
+   int max_eval_time
+) {
+   bhm_error_code_t bhm_error;
+
+   context->max_eval_time = max_eval_time;
+   context->ticks_count = 0;
+   #ifdef GRAPHICS
+   context->viewer = NULL;
+   context->viewer_channel = 0;
+   context->episodes_count = 0;
+   context->step_period = 0;
+   #endif
+
+   for (int i = 0; i < 2; i++) {
+      bhm_error = c2d_create(&(context->cortices[i]), cortex->width, cortex->height, cortex->nh_radius);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error creating cortex %d\n", bhm_error);
+         return bhm_error;
+      }
+   }
 
-   snaken2d_t* snaken = NULL;
-   snaken_error = create_snaken(
-      &snaken,
+   snaken_error_code_t snaken_error = create_snaken(
+      &(context->snaken),
       WORLD_WIDTH,
       WORLD_HEIGHT
    );
@@ -156,33 +409,27 @@ bhm_error_code_t eval_cortex(
       printf("There was an error creating the snaken: %d\n", snaken_error);
       return BHM_ERROR_EXTERNAL_CAUSES;
    }
-   // ##########################################
-   // ##########################################
-
 
    // ##########################################
    // Input init.
    // ##########################################
-   bhm_ticks_count_t mean_input = 0;
-   snaken_world_size_t snaken_view_width = NH_DIAM_2D(snaken->snake_view_radius);
-   snaken_cell_type_t* snake_view = (snaken_cell_type_t*) malloc(snaken_view_width * snaken_view_width * sizeof(snaken_cell_type_t));
-   bhm_cortex_size_t input_width = clamp(snaken_view_width * snaken_view_width, 0, cortex->width);
-   bhm_input2d_t* input;
+   snaken_world_size_t snaken_view_width = NH_DIAM_2D(context->snaken->snake_view_radius);
+   context->snake_view = (snaken_cell_type_t*) malloc(snaken_view_width * snaken_view_width * sizeof(snaken_cell_type_t));
+   context->input_width = clamp(snaken_view_width * snaken_view_width, 0, cortex->width);
    bhm_error = i2d_init(
-      &input,
-      (cortex->width / 2) - (input_width / 2),
+      &(context->input),
+      (cortex->width / 2) - (context->input_width / 2),
       0,
-      (cortex->width / 2) + (input_width / 2),
+      (cortex->width / 2) + (context->input_width / 2),
       1,
       BHM_MAX_EXC_VALUE * 2,
       BHM_PULSE_MAPPING_FPROP
    );
    if (bhm_error != BHM_ERROR_NONE) {
-      printf("i2d x0 %d x1 %d\n", (cortex->width / 2) - (input_width / 2), (cortex->width / 2) + (input_width / 2));
+      printf("i2d x0 %d x1 %d\n", (cortex->width / 2) - (context->input_width / 2), (cortex->width / 2) + (context->input_width / 2));
       printf("There was an error allocating input %d\n", bhm_error);
       return bhm_error;
    }
-
    // ##########################################
    // ##########################################
 
@@ -193,10 +440,8 @@ bhm_error_code_t eval_cortex(
    bhm_cortex_size_t output_width = 4;
 
    // The left output is in the bottom left part of the cortex.
-   bhm_ticks_count_t mean_left_output = 0;
-   bhm_output2d_t* left_output;
    bhm_error = o2d_init(
-      &left_output,
+      &(context->left_output),
       (cortex->width / 4) - (output_width / 2),
       cortex->height - 1,
       (cortex->width / 4) + (output_width / 2),
@@ -208,10 +453,8 @@ bhm_error_code_t eval_cortex(
    }
 
    // The right output is in the bottom right part of the cortex.
-   bhm_ticks_count_t mean_right_output = 0;
-   bhm_output2d_t* right_output;
    bhm_error = o2d_init(
-      &right_output,
+      &(context->right_output),
       (cortex->width * 3 / 4) - (output_width / 2),
       cortex->height - 1,
       (cortex->width * 3 / 4) + (output_width / 2),
@@ -224,28 +467,211 @@ bhm_error_code_t eval_cortex(
    // ##########################################
    // ##########################################
 
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Destroys the content of the provided evaluation context.
+/// @param context The context to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_context_destroy(eval_context_t* context) {
+   bhm_error_code_t bhm_error;
+
+   for (int i = 0; i < 2; i++) {
+      bhm_error = c2d_destroy(context->cortices[i]);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error destroying the tmp cortex: %d\n", bhm_error);
+         return bhm_error;
+      }
+   }
+   bhm_error = i2d_destroy(context->input);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error destroying the cortex input: %d\n", bhm_error);
+      return bhm_error;
+   }
+   bhm_error = o2d_destroy(context->left_output);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error destroying the left output: %d\n", bhm_error);
+      return bhm_error;
+   }
+   bhm_error = o2d_destroy(context->right_output);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error destroying the right output: %d\n", bhm_error);
+      return bhm_error;
+   }
+   snaken_error_code_t snaken_error = snaken2d_destroy(context->snaken);
+   if (snaken_error != SNAKEN_ERROR_NONE) {
+      printf("There was an error destroying the snaken: %d\n", snaken_error);
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+
+   free(context->snake_view);
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Upper bound on the fitness of a cortex over all its episodes, shared by the workers running them.
+/// Lets workers drop all episodes of a cortex as soon as it cannot make it into the selection pool anymore.
+typedef struct {
+   // Sum over all episodes of the highest fitness each can still reach, lowered as episodes go on.
+   _Atomic int64_t bound_sum;
+
+   // Number of episodes not over yet.
+   _Atomic int remaining_episodes;
+
+   // Whether the cortex was found unable to reach the cutoff, and its episodes dropped.
+   _Atomic uint8_t pruned;
+} eval_bound_t;
+
+/// @brief Computes the highest fitness an episode can still reach.
+/// Apples never spawn under the snake head or on other apples, so the snake eats at most one apple per move, growing by one,
+/// and cannot outlive max_eval_time steps.
+/// It also starves one piece every (stamina + 1) steps, and every apple at most buys it two more such periods:
+/// one for the piece it adds and one for the hunger it resets.
+/// @param snake_speed The speed of the snake.
+/// @param snake_stamina The stamina of the snake.
+/// @param snake_length The current snake length.
+/// @param eaten_apples_count The number of apples eaten so far.
+/// @param timestep The number of steps run so far.
+/// @param max_eval_time The maximum number of steps the episode can take.
+/// @return The fitness bound.
+int64_t eval_fitness_bound(
+   snaken_snake_speed_t snake_speed,
+   snaken_snake_stamina_t snake_stamina,
+   snaken_world_size_t snake_length,
+   snaken_world_size_t eaten_apples_count,
+   int64_t timestep,
+   int64_t max_eval_time
+) {
+   // The snake only moves once every (~speed) steps.
+   int64_t move_period = (snaken_snake_speed_t) (~snake_speed);
+   if (move_period < 1) move_period = 1;
+   int64_t steps_left = max_eval_time - timestep;
+   int64_t moves_left = steps_left / move_period + 1;
+
+   int64_t survival_steps = ((int64_t) snake_length + 2 * moves_left) * ((int64_t) snake_stamina + 1);
+   if (survival_steps < steps_left) steps_left = survival_steps;
+
+   return (
+      2 * ((int64_t) snake_length + moves_left) +
+      100 * ((int64_t) eaten_apples_count + moves_left) +
+      5 * (timestep + steps_left)
+   );
+}
+
+/// @brief Evaluates the provided cortex on the episode of the provided seed, using the resources of the provided context.
+/// @param context The context to evaluate the cortex in.
+/// @param cortex The cortex to evaluate, left untouched.
+/// @param seed The seed of the episode to evaluate the cortex on.
+/// @param bound The fitness bound of the cortex, NULL to always run the whole episode.
+/// @param cutoff The sum of fitness over all episodes the cortex needs to reach not to be dropped, only used with bound.
+/// @param fitness The cortex fitness score as a result of the evaluation process, only partial if the cortex was dropped.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_cortex_in(
+   eval_context_t* context,
+   bhm_cortex2d_t* cortex,
+   uint64_t seed,
+   eval_bound_t* bound,
+   _Atomic int64_t* cutoff,
+   bhm_cortex_fitness_t* fitness
+) {
+   // ##########################################
+   // Init cortices.
+   // ##########################################
+   bhm_error_code_t bhm_error;
+
+   for (int i = 0; i < 2; i++) {
+      bhm_error = c2d_copy(context->cortices[i], cortex);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error copying cortex %d\n", bhm_error);
+         return bhm_error;
+      }
+   }
+
+   bhm_cortex_counts_t counts = {
+      .ticks_count = 0x00,
+      .evols_count = 0x00
+   };
+   // ##########################################
+   // ##########################################
+
+
+   // ##########################################
+   // Init snaken.
+   // ##########################################
+   snaken_error_code_t snaken_error;
+
+   // Start a new episode in the context world, then restore the snake length the reset just shrunk.
+   snaken2d_t* snaken = context->snaken;
+   snaken_error = snaken2d_reset(snaken, seed);
+   if (snaken_error != SNAKEN_ERROR_NONE) {
+      printf("There was an error resetting the snaken: %d\n", snaken_error);
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+   snaken_error = snaken2d_set_snake_length(snaken, SNAKE_LENGTH);
+   if (snaken_error != SNAKEN_ERROR_NONE) {
+      printf("There was an error updating the snake length: %d\n", snaken_error);
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+
+   bhm_ticks_count_t mean_input = 0;
+   snaken_world_size_t snaken_view_width = NH_DIAM_2D(snaken->snake_view_radius);
+   snaken_cell_type_t* snake_view = context->snake_view;
+   bhm_cortex_size_t input_width = context->input_width;
+   bhm_input2d_t* input = context->input;
+
+   bhm_ticks_count_t mean_left_output = 0;
+   bhm_output2d_t* left_output = context->left_output;
+   bhm_ticks_count_t mean_right_output = 0;
+   bhm_output2d_t* right_output = context->right_output;
+   // ##########################################
+   // ##########################################
+
    // ##########################################
    // Run evaluation.
    // ##########################################
 
    bhm_ticks_count_t timestep = 0;
 
-   // uint64_t t0 = nanos();
-   // uint64_t t1 = t0;
+   // Bound this episode accounts for in the cortex bound sum, starting from the one of a fresh episode.
+   int64_t episode_bound = eval_fitness_bound(snaken->snake_speed, snaken->snake_stamina, snaken->snake_length, 0, 0, context->max_eval_time);
+
+   #ifdef GRAPHICS
+   struct timespec next_step;
+   clock_gettime(CLOCK_MONOTONIC, &next_step);
+   #endif
 
-   for (; timestep < MAX_EVAL_TIME; timestep++) {
+   for (; timestep < context->max_eval_time; timestep++) {
 
       // Make sure the snake is still alive before going on.
       if (!snaken->snake_alive) break;
 
-      bhm_cortex2d_t* prev_cortex = timestep % 2 ? tmp_cortex : cortex;
-      bhm_cortex2d_t* next_cortex = timestep % 2 ? cortex : tmp_cortex;
+      // Periodically tighten the cortex bound, and drop the episode if the cortex cannot reach the cutoff anymore.
+      if (bound != NULL && timestep % EVAL_BOUND_INTERVAL == 0) {
+         int64_t new_bound = eval_fitness_bound(
+            snaken->snake_speed,
+            snaken->snake_stamina,
+            snaken->snake_length,
+            snaken->eaten_apples_count,
+            timestep,
+            context->max_eval_time
+         );
+         int64_t bound_sum = atomic_fetch_sub(&(bound->bound_sum), episode_bound - new_bound) - (episode_bound - new_bound);
+         episode_bound = new_bound;
+
+         if (atomic_load(&(bound->pruned)) || bound_sum < atomic_load(cutoff)) {
+            atomic_store(&(bound->pruned), BHM_TRUE);
+            break;
+         }
+      }
+
+      bhm_cortex2d_t* prev_cortex = context->cortices[timestep % 2];
+      bhm_cortex2d_t* next_cortex = context->cortices[(timestep + 1) % 2];
 
       // Defines whether to evolve or not.
       // evol_step is incremented by 1 to account for edge cases and human readable behavior:
       // 0x0000 -> 0 + 1 = 1, so the cortex evolves at every tick, meaning that there are no free ticks between evolutions.
       // 0xFFFF -> 65535 + 1 = 65536, so the cortex never evolves, meaning that there is an infinite amount of ticks between evolutions.
-      bhm_bool_t evolve = (counts->ticks_count % (((bhm_evol_step_t) prev_cortex->evol_step) + 1)) == 0;
+      bhm_bool_t evolve = (counts.ticks_count % (((bhm_evol_step_t) prev_cortex->evol_step) + 1)) == 0;
 
       // Get snake view as input.
       snaken_error = snaken2d_get_snake_view(snaken, snake_view);
@@ -254,15 +680,6 @@ bhm_error_code_t eval_cortex(
          return BHM_ERROR_EXTERNAL_CAUSES;
       }
 
-      // print_snake_view(snake_view, NH_DIAM_2D(snaken->snake_view_radius));
-
-      // t1 = nanos();
-      // printf("Got snake view in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
-      // printf("SNAKE_DIR: %d\n", snaken->snake_direction);
-      // print_snake_view(snake_view, snaken_view_width);
-
       // Feed input to the cortex.
       // Only the frontal snake view is fed as input to the network.
       for (bhm_cortex_size_t y = 0; y < input->y1 - input->y0; y++) {
@@ -288,10 +705,6 @@ bhm_error_code_t eval_cortex(
          timestep
       );
 
-      // t1 = nanos();
-      // printf("Fed cortex in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
       // Tick the cortex.
       c2d_tick(
          prev_cortex,
@@ -299,13 +712,9 @@ bhm_error_code_t eval_cortex(
          evolve
       );
 
-      // t1 = nanos();
-      // printf("Ticked cortex in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
-      counts->ticks_count++;
+      counts.ticks_count++;
       // Increment evolutions count.
-      if (evolve) counts->evols_count++;
+      if (evolve) counts.evols_count++;
 
       // Tick the snaken.
       snaken_error = snaken2d_tick(snaken);
@@ -314,25 +723,13 @@ bhm_error_code_t eval_cortex(
          return BHM_ERROR_EXTERNAL_CAUSES;
       }
 
-      // t1 = nanos();
-      // printf("Ticked snaken in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
       // Read cortex output.
       c2d_read2d(next_cortex, left_output);
       c2d_read2d(next_cortex, right_output);
 
-      // t1 = nanos();
-      // printf("Read output in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
       o2d_mean(left_output, &mean_left_output);
       o2d_mean(right_output, &mean_right_output);
 
-      // t1 = nanos();
-      // printf("Meaned output in %llu ns\n", t1 - t0);
-      // t0 = nanos();
-
       // Use cortex output to control the snake.
       // The snake should do nothing (keep going straight) if the two outputs are equal.
       if (mean_left_output > mean_right_output) {
@@ -341,86 +738,1093 @@ bhm_error_code_t eval_cortex(
          snaken2d_turn_right(snaken);
       }
 
-      // t1 = nanos();
-      // printf("Applied turning in %llu ns\n\n", t1 - t0);
-      // t0 = nanos();
-
       #ifdef GRAPHICS
-      switch(GetKeyPressed()) {
-         case KEY_SPACE:
+      // Publish the step for the viewer to pick up whenever it draws next.
+      if (context->viewer != NULL &&
+          viewer_publish(context->viewer, context->viewer_channel, snaken, prev_cortex, context->episodes_count)) {
+         // Pace steps on an absolute schedule, so that publishing time does not add up.
+         if (context->step_period > 0) {
+            next_step.tv_nsec += context->step_period;
+            while (next_step.tv_nsec >= 1000000000L) {
+               next_step.tv_sec++;
+               next_step.tv_nsec -= 1000000000L;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_step, NULL);
+         }
       }
-      BeginDrawing();
-         ClearBackground(BLACK);
-         draw_snaken(
-            snaken,
-            WINDOW_WIDTH,
-            WINDOW_HEIGHT
-         );
-         draw_cortex(
-            prev_cortex,
-            WINDOW_WIDTH,
-            WINDOW_HEIGHT
-         );
-      EndDrawing();
       #endif
 
       // usleep(10000);
    }
 
-   // printf("Evaluated cortex in %llu ms\n", millis() - t0);
-
    // ##########################################
    // ##########################################
 
+   #ifdef GRAPHICS
+   // Publish the final step as well, so that the viewer shows how the episode ended.
+   if (context->viewer != NULL) {
+      viewer_publish(context->viewer, context->viewer_channel, snaken, context->cortices[timestep % 2], context->episodes_count);
+   }
+   context->episodes_count++;
+   #endif
+
    *fitness = (
       2 * snaken->snake_length +
       100 * snaken->eaten_apples_count +
       5 * timestep
    );
+   context->ticks_count += timestep;
 
-   // Cleanup.
-   bhm_error = c2d_destroy(tmp_cortex);
-   if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error destroying the tmp cortex: %d\n", bhm_error);
-      return bhm_error;
+   // The episode is over, so its bound is now its actual fitness.
+   if (bound != NULL && !atomic_load(&(bound->pruned))) {
+      atomic_fetch_sub(&(bound->bound_sum), episode_bound - (int64_t) *fitness);
    }
-   bhm_error = i2d_destroy(input);
-   if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error destroying the cortex input: %d\n", bhm_error);
-      return bhm_error;
-   }
-   bhm_error = o2d_destroy(left_output);
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Evaluates the provided cortex in a context of its own.
+/// Only used as the population evaluation function, since evolution evaluates cortices through an [eval_pool_t].
+/// @param cortex The cortex to evaluate.
+/// @param fitness The cortex fitness score as a result of the evaluation process.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_cortex(
+   bhm_cortex2d_t* cortex,
+   bhm_cortex_fitness_t* fitness
+) {
+   bhm_error_code_t bhm_error;
+   eval_context_t context;
+
+   bhm_error = eval_context_init(&context, cortex, MAX_EVAL_TIME);
    if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error destroying the left output: %d\n", bhm_error);
       return bhm_error;
    }
-   bhm_error = o2d_destroy(right_output);
+
+   bhm_error = eval_cortex_in(&context, cortex, ((uint64_t) rand() << 32) ^ (uint64_t) rand(), NULL, NULL, fitness);
    if (bhm_error != BHM_ERROR_NONE) {
-      printf("There was an error destroying the right output: %d\n", bhm_error);
       return bhm_error;
    }
-   snaken_error = snaken2d_destroy(snaken);
-   if (snaken_error != SNAKEN_ERROR_NONE) {
-      printf("There was an error destroying the snaken: %d\n", snaken_error);
-      return BHM_ERROR_EXTERNAL_CAUSES;
+
+   return eval_context_destroy(&context);
+}
+
+/// @brief Feeds the provided bytes to the provided FNV-1a hash.
+/// @param data The bytes to hash.
+/// @param size The number of bytes to hash.
+/// @param hash The hash to feed, [FNV_OFFSET_BASIS] to start a new one.
+/// @return The updated hash.
+uint64_t hash_bytes(const void* data, size_t size, uint64_t hash) {
+   const uint8_t* bytes = (const uint8_t*) data;
+   for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= FNV_PRIME;
    }
+   return hash;
+}
 
-   free(snake_view);
+/// @brief Computes a hash of the whole content of the provided cortex: its parameters and all its neurons.
+/// @param cortex The cortex to hash.
+/// @return The cortex hash.
+uint64_t cortex_hash(bhm_cortex2d_t* cortex) {
+   // Leave the neurons pointer out, since equal cortices never share neurons.
+   bhm_cortex2d_t params;
+   memcpy(&params, cortex, sizeof(bhm_cortex2d_t));
+   params.neurons = NULL;
+
+   uint64_t hash = hash_bytes(&params, sizeof(bhm_cortex2d_t), FNV_OFFSET_BASIS);
+   return hash_bytes(cortex->neurons, (size_t) cortex->width * cortex->height * sizeof(bhm_neuron_t), hash);
+}
 
-   return BHM_ERROR_NONE;
+/// @brief Fitness of an already evaluated cortex on a given set of seeds.
+typedef struct {
+   // Hash of cortex and seeds, 0 for empty entries.
+   uint64_t key;
+   bhm_cortex_fitness_t fitness;
+} fitness_cache_entry_t;
+
+/// @brief Open addressing table of the fitness of already evaluated cortices.
+typedef struct {
+   fitness_cache_entry_t* entries;
+
+   // Always a power of 2, so that keys can be masked into slots.
+   uint32_t capacity;
+   uint32_t length;
+} fitness_cache_t;
+
+/// @brief Computes the cache key of the provided cortex evaluated on the provided seeds.
+/// @param cortex The evaluated cortex.
+/// @param seeds_hash The hash of the seeds the cortex is evaluated on.
+/// @return The cache key, never 0.
+uint64_t fitness_cache_key(bhm_cortex2d_t* cortex, uint64_t seeds_hash) {
+   uint64_t key = hash_bytes(&seeds_hash, sizeof(uint64_t), cortex_hash(cortex));
+   return key == 0 ? 1 : key;
 }
 
-int evolve(
-   int pop_size,
-   int max_eval_time,
-   int gens_count,
-   char* pop_file_name
-) {
-   bhm_error_code_t bhm_error;
-   bhm_population2d_t* population;
+/// @brief Empties the provided cache.
+/// @param cache The cache to empty.
+void fitness_cache_clear(fitness_cache_t* cache) {
+   memset(cache->entries, 0, cache->capacity * sizeof(fitness_cache_entry_t));
+   cache->length = 0;
+}
 
-   if (pop_file_name != NULL) {
-      // ##########################################
+/// @brief Looks the provided key up in the provided cache.
+/// @param cache The cache to look into.
+/// @param key The key to look for.
+/// @param fitness The cached fitness, if any.
+/// @return Whether the key was found.
+bhm_bool_t fitness_cache_get(fitness_cache_t* cache, uint64_t key, bhm_cortex_fitness_t* fitness) {
+   for (uint32_t slot = key & (cache->capacity - 1); cache->entries[slot].key != 0; slot = (slot + 1) & (cache->capacity - 1)) {
+      if (cache->entries[slot].key == key) {
+         *fitness = cache->entries[slot].fitness;
+         return BHM_TRUE;
+      }
+   }
+   return BHM_FALSE;
+}
+
+/// @brief Stores the provided fitness in the provided cache.
+/// The cache is emptied rather than grown once half full, since only the latest cortices are worth remembering.
+/// @param cache The cache to store into.
+/// @param key The key to store the fitness at.
+/// @param fitness The fitness to store.
+void fitness_cache_put(fitness_cache_t* cache, uint64_t key, bhm_cortex_fitness_t fitness) {
+   if (cache->length * 2 >= cache->capacity) fitness_cache_clear(cache);
+
+   uint32_t slot = key & (cache->capacity - 1);
+   for (; cache->entries[slot].key != 0; slot = (slot + 1) & (cache->capacity - 1)) {
+      if (cache->entries[slot].key == key) break;
+   }
+   if (cache->entries[slot].key == 0) cache->length++;
+   cache->entries[slot].key = key;
+   cache->entries[slot].fitness = fitness;
+}
+
+typedef struct eval_pool_t eval_pool_t;
+
+/// @brief Worker of an evaluation pool, owning its evaluation resources and its queue of cortices.
+typedef struct {
+   eval_pool_t* pool;
+   eval_context_t context;
+
+   // Episodes still to evaluate: the first one in the lower half, one past the last in the upper half.
+   // Packing both ends lets the owner pop from the front and thieves steal from the back with a single compare and swap.
+   _Atomic uint64_t queue;
+
+   pthread_t thread;
+} eval_worker_t;
+
+/// @brief Pool of workers evaluating a population in parallel, where idle workers steal cortices from busy ones.
+/// Episodes vary wildly in length, so splitting the population evenly alone would leave workers idle.
+struct eval_pool_t {
+   int workers_count;
+   eval_worker_t* workers;
+
+   // Population currently being evaluated.
+   bhm_population2d_t* population;
+
+   // Indexes of the cortices actually being evaluated, the others' fitness being cached.
+   // Every pending cortex makes [seeds_count] episodes, the one of pending cortex p on seed s being p * seeds_count + s.
+   bhm_population_size_t* pending;
+   bhm_population_size_t pending_count;
+
+   // Fitness of every episode of every cortex, aggregated into the cortex fitness once all are over.
+   bhm_cortex_fitness_t* episodes_fitness;
+
+   // Fitness bound of every pending cortex.
+   eval_bound_t* bounds;
+   bhm_bool_t pruning;
+
+   // Best fitness known so far in the current evaluation, as many as the selection pool holds, in descending order.
+   bhm_cortex_fitness_t* best_fitness;
+   bhm_population_size_t best_length;
+
+   // Sum of fitness over all episodes a cortex needs to reach in order to beat the worst of [best_fitness] once full.
+   _Atomic int64_t cutoff;
+
+   // Cache key of every cortex of the population.
+   uint64_t* keys;
+
+   fitness_cache_t cache;
+
+   // Seeds all cortices are evaluated on, so that all of them face the very same episodes and their fitness is comparable.
+   // They change every [reeval_interval] evaluations so that cortices do not overfit them.
+   uint64_t* eval_seeds;
+   int seeds_count;
+   uint64_t seeds_hash;
+   int reeval_interval;
+   snaken_rng_t rng;
+
+   // Last error occurred during the current evaluation.
+   bhm_error_code_t error;
+
+   // Synchronization between the calling thread and the helper workers.
+   pthread_mutex_t lock;
+   pthread_cond_t work_available;
+   pthread_cond_t work_done;
+   uint64_t generation;
+   int busy_count;
+   bhm_bool_t stopping;
+};
+
+/// @brief Takes the next episode from the front of the provided queue.
+/// @param queue The queue to pop from.
+/// @param episode The popped episode.
+/// @return Whether any episode was popped.
+bhm_bool_t eval_queue_pop(_Atomic uint64_t* queue, uint32_t* episode) {
+   uint64_t range = atomic_load(queue);
+   for (;;) {
+      uint32_t begin = (uint32_t) range;
+      uint32_t end = (uint32_t) (range >> 32);
+      if (begin >= end) return BHM_FALSE;
+
+      if (atomic_compare_exchange_weak(queue, &range, ((uint64_t) end << 32) | (begin + 1))) {
+         *episode = begin;
+         return BHM_TRUE;
+      }
+   }
+}
+
+/// @brief Takes the last episode from the back of the provided queue.
+/// @param queue The queue to steal from.
+/// @param episode The stolen episode.
+/// @return Whether any episode was stolen.
+bhm_bool_t eval_queue_steal(_Atomic uint64_t* queue, uint32_t* episode) {
+   uint64_t range = atomic_load(queue);
+   for (;;) {
+      uint32_t begin = (uint32_t) range;
+      uint32_t end = (uint32_t) (range >> 32);
+      if (begin >= end) return BHM_FALSE;
+
+      if (atomic_compare_exchange_weak(queue, &range, ((uint64_t) (end - 1) << 32) | begin)) {
+         *episode = end - 1;
+         return BHM_TRUE;
+      }
+   }
+}
+
+/// @brief Records the provided cortex fitness among the best known ones, raising the cutoff once the selection pool would be full.
+/// @warning Must be called with the pool lock held, or before workers are started.
+/// @param pool The pool to record the fitness in.
+/// @param fitness The fitness of a fully evaluated cortex.
+void eval_pool_record_best(eval_pool_t* pool, bhm_cortex_fitness_t fitness) {
+   bhm_population_size_t best_size = pool->population->selection_pool_size;
+   if (best_size == 0) return;
+   if (pool->best_length == best_size && fitness <= pool->best_fitness[best_size - 1]) return;
+
+   // Insert the fitness in order, dropping the worst one if already full.
+   bhm_population_size_t i = pool->best_length < best_size ? pool->best_length++ : best_size - 1;
+   for (; i > 0 && pool->best_fitness[i - 1] < fitness; i--) {
+      pool->best_fitness[i] = pool->best_fitness[i - 1];
+   }
+   pool->best_fitness[i] = fitness;
+
+   if (pool->best_length == best_size) {
+      atomic_store(&(pool->cutoff), (int64_t) pool->best_fitness[best_size - 1] * pool->seeds_count);
+   }
+}
+
+/// @brief Evaluates episodes from the worker own queue, then from other workers' until none is left.
+/// @param worker The worker to run.
+void eval_worker_run(eval_worker_t* worker) {
+   eval_pool_t* pool = worker->pool;
+   int self = (int) (worker - pool->workers);
+   uint32_t episode;
+
+   for (;;) {
+      bhm_bool_t found = eval_queue_pop(&(worker->queue), &episode);
+
+      // Look for work starting from the next worker, so that thieves spread over victims.
+      for (int i = 1; !found && i < pool->workers_count; i++) {
+         found = eval_queue_steal(&(pool->workers[(self + i) % pool->workers_count].queue), &episode);
+      }
+
+      // No work is ever added during an evaluation, so empty queues mean it is over.
+      if (!found) return;
+
+      bhm_population_size_t p = episode / pool->seeds_count;
+      bhm_population_size_t index = pool->pending[p];
+      eval_bound_t* bound = &(pool->bounds[p]);
+      bhm_error_code_t bhm_error = eval_cortex_in(
+         &(worker->context),
+         &(pool->population->cortices[index]),
+         pool->eval_seeds[episode % pool->seeds_count],
+         pool->pruning ? bound : NULL,
+         &(pool->cutoff),
+         &(pool->episodes_fitness[episode])
+      );
+      if (bhm_error != BHM_ERROR_NONE) {
+         pthread_mutex_lock(&(pool->lock));
+         pool->error = bhm_error;
+         pthread_mutex_unlock(&(pool->lock));
+      }
+
+      // The worker finishing the last episode of a cortex aggregates its fitness, so that it can raise the cutoff right away.
+      if (atomic_fetch_sub(&(bound->remaining_episodes), 1) == 1) {
+         uint64_t total_fitness = 0;
+         for (int s = 0; s < pool->seeds_count; s++) {
+            total_fitness += pool->episodes_fitness[(size_t) p * pool->seeds_count + s];
+         }
+         pool->population->cortices_fitness[index] = (bhm_cortex_fitness_t) (total_fitness / pool->seeds_count);
+
+         if (!atomic_load(&(bound->pruned))) {
+            pthread_mutex_lock(&(pool->lock));
+            eval_pool_record_best(pool, pool->population->cortices_fitness[index]);
+            pthread_mutex_unlock(&(pool->lock));
+         }
+      }
+   }
+}
+
+/// @brief Thread routine of helper workers, running every evaluation the pool is asked for.
+/// @param arg The worker to run.
+void* eval_worker_loop(void* arg) {
+   eval_worker_t* worker = (eval_worker_t*) arg;
+   eval_pool_t* pool = worker->pool;
+   uint64_t generation = 0;
+
+   pthread_mutex_lock(&(pool->lock));
+   for (;;) {
+      while (!pool->stopping && pool->generation == generation) {
+         pthread_cond_wait(&(pool->work_available), &(pool->lock));
+      }
+      if (pool->stopping) break;
+      generation = pool->generation;
+      pthread_mutex_unlock(&(pool->lock));
+
+      eval_worker_run(worker);
+
+      pthread_mutex_lock(&(pool->lock));
+      pool->busy_count--;
+      if (pool->busy_count == 0) pthread_cond_signal(&(pool->work_done));
+   }
+   pthread_mutex_unlock(&(pool->lock));
+
+   return NULL;
+}
+
+/// @brief Initializes an evaluation pool for the provided population.
+/// The calling thread acts as the first worker, so only workers_count - 1 threads are started.
+/// @param pool The pool to initialize.
+/// @param workers_count The number of workers, 0 for one per online processor.
+/// @param population The population to evaluate, whose size and cortices shape never change.
+/// @param max_eval_time The maximum number of steps each evaluation can take.
+/// @param seeds_count The number of episodes every cortex is evaluated on.
+/// @param reeval_interval The number of evaluations after which the evaluation seeds change, 0 for never.
+/// @param pruning Whether to drop the episodes of cortices that cannot make it into the selection pool anymore.
+/// @param seed The seed all evaluation seeds are derived from.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_pool_init(
+   eval_pool_t** pool,
+   int workers_count,
+   bhm_population2d_t* population,
+   int max_eval_time,
+   int seeds_count,
+   int reeval_interval,
+   bhm_bool_t pruning,
+   snaken_rng_t seed
+) {
+   bhm_error_code_t bhm_error;
+
+   if (workers_count <= 0) workers_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+   if (workers_count <= 0) workers_count = 1;
+   if (seeds_count <= 0) seeds_count = 1;
+
+   (*pool) = (eval_pool_t*) malloc(sizeof(eval_pool_t));
+   if ((*pool) == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
+   }
+   (*pool)->workers_count = workers_count;
+   (*pool)->population = NULL;
+   (*pool)->error = BHM_ERROR_NONE;
+   (*pool)->generation = 0;
+   (*pool)->busy_count = 0;
+   (*pool)->stopping = BHM_FALSE;
+   (*pool)->seeds_count = seeds_count;
+   (*pool)->seeds_hash = 0;
+   (*pool)->reeval_interval = reeval_interval;
+   (*pool)->rng = seed;
+   (*pool)->pruning = pruning;
+   (*pool)->best_length = 0;
+   atomic_init(&((*pool)->cutoff), 0);
+   pthread_mutex_init(&((*pool)->lock), NULL);
+   pthread_cond_init(&((*pool)->work_available), NULL);
+   pthread_cond_init(&((*pool)->work_done), NULL);
+
+   (*pool)->pending = (bhm_population_size_t*) malloc(population->size * sizeof(bhm_population_size_t));
+   (*pool)->pending_count = 0;
+   (*pool)->episodes_fitness = (bhm_cortex_fitness_t*) malloc((size_t) population->size * seeds_count * sizeof(bhm_cortex_fitness_t));
+   (*pool)->eval_seeds = (uint64_t*) malloc(seeds_count * sizeof(uint64_t));
+   (*pool)->bounds = (eval_bound_t*) malloc(population->size * sizeof(eval_bound_t));
+   (*pool)->best_fitness = (bhm_cortex_fitness_t*) malloc((population->selection_pool_size + 1) * sizeof(bhm_cortex_fitness_t));
+   (*pool)->keys = (uint64_t*) malloc(population->size * sizeof(uint64_t));
+
+   // Leave room for a few generations of distinct cortices before the cache fills up.
+   (*pool)->cache.capacity = 1;
+   while ((*pool)->cache.capacity < 8 * (uint32_t) population->size) (*pool)->cache.capacity <<= 1;
+   (*pool)->cache.length = 0;
+   (*pool)->cache.entries = (fitness_cache_entry_t*) calloc((*pool)->cache.capacity, sizeof(fitness_cache_entry_t));
+
+   (*pool)->workers = (eval_worker_t*) malloc(workers_count * sizeof(eval_worker_t));
+   if ((*pool)->pending == NULL || (*pool)->episodes_fitness == NULL || (*pool)->eval_seeds == NULL || (*pool)->bounds == NULL ||
+       (*pool)->best_fitness == NULL || (*pool)->keys == NULL || (*pool)->cache.entries == NULL || (*pool)->workers == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
+   }
+
+   for (int i = 0; i < workers_count; i++) {
+      eval_worker_t* worker = &((*pool)->workers[i]);
+      worker->pool = *pool;
+      atomic_init(&(worker->queue), 0);
+
+      // All cortices share the same shape, so any of them can size the evaluation resources.
+      bhm_error = eval_context_init(&(worker->context), &(population->cortices[0]), max_eval_time);
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+   }
+
+   for (int i = 1; i < workers_count; i++) {
+      if (pthread_create(&((*pool)->workers[i].thread), NULL, &eval_worker_loop, &((*pool)->workers[i])) != 0) {
+         printf("There was an error starting evaluation worker %d\n", i);
+         return BHM_ERROR_EXTERNAL_CAUSES;
+      }
+   }
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Stops all workers and destroys the provided evaluation pool.
+/// @param pool The pool to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_pool_destroy(eval_pool_t* pool) {
+   pthread_mutex_lock(&(pool->lock));
+   pool->stopping = BHM_TRUE;
+   pthread_cond_broadcast(&(pool->work_available));
+   pthread_mutex_unlock(&(pool->lock));
+
+   for (int i = 1; i < pool->workers_count; i++) {
+      pthread_join(pool->workers[i].thread, NULL);
+   }
+
+   for (int i = 0; i < pool->workers_count; i++) {
+      bhm_error_code_t bhm_error = eval_context_destroy(&(pool->workers[i].context));
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+   }
+
+   pthread_mutex_destroy(&(pool->lock));
+   pthread_cond_destroy(&(pool->work_available));
+   pthread_cond_destroy(&(pool->work_done));
+   free(pool->pending);
+   free(pool->episodes_fitness);
+   free(pool->eval_seeds);
+   free(pool->bounds);
+   free(pool->best_fitness);
+   free(pool->keys);
+   free(pool->cache.entries);
+   free(pool->workers);
+   free(pool);
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Statistics of the evaluation of a population.
+typedef struct {
+   // Number of cortices whose fitness was cached.
+   bhm_population_size_t cached_count;
+
+   // Number of cortices dropped before the end of their episodes, whose fitness is only partial.
+   bhm_population_size_t pruned_count;
+
+   // Number of steps run over all episodes.
+   uint64_t ticks_count;
+} eval_stats_t;
+
+/// @brief Evaluates all cortices of the provided population, writing their fitness in its cortices_fitness.
+/// The fitness of a cortex is its mean fitness over the episodes of all current seeds, all run in parallel.
+/// Cortices already evaluated on the current seeds, such as unchanged survivors, get their cached fitness instead.
+/// @param pool The pool to evaluate the population with.
+/// @param population The population to evaluate.
+/// @param stats The statistics of the evaluation.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t eval_pool_evaluate(
+   eval_pool_t* pool,
+   bhm_population2d_t* population,
+   eval_stats_t* stats
+) {
+   // Move on to new seeds every reeval_interval evaluations, which makes all cached fitness stale.
+   if (pool->generation == 0 || (pool->reeval_interval > 0 && pool->generation % pool->reeval_interval == 0)) {
+      for (int s = 0; s < pool->seeds_count; s++) {
+         pool->eval_seeds[s] = snaken_rng_next(&(pool->rng));
+      }
+      pool->seeds_hash = hash_bytes(pool->eval_seeds, pool->seeds_count * sizeof(uint64_t), FNV_OFFSET_BASIS);
+      fitness_cache_clear(&(pool->cache));
+   }
+
+   // Cached fitness sets the cutoff before any episode even starts.
+   pool->population = population;
+   pool->best_length = 0;
+   atomic_store(&(pool->cutoff), 0);
+
+   // Only evaluate cortices whose fitness on the current seeds is unknown.
+   pool->pending_count = 0;
+   for (bhm_population_size_t i = 0; i < population->size; i++) {
+      pool->keys[i] = fitness_cache_key(&(population->cortices[i]), pool->seeds_hash);
+      if (fitness_cache_get(&(pool->cache), pool->keys[i], &(population->cortices_fitness[i]))) {
+         eval_pool_record_best(pool, population->cortices_fitness[i]);
+      } else {
+         pool->pending[pool->pending_count++] = i;
+      }
+   }
+   stats->cached_count = population->size - pool->pending_count;
+
+   // Every episode starts out accounting for the bound of a fresh one.
+   eval_context_t* context = &(pool->workers[0].context);
+   int64_t episode_bound = eval_fitness_bound(context->snaken->snake_speed, context->snaken->snake_stamina, SNAKE_LENGTH, 0, 0, context->max_eval_time);
+   for (bhm_population_size_t p = 0; p < pool->pending_count; p++) {
+      atomic_store(&(pool->bounds[p].bound_sum), episode_bound * pool->seeds_count);
+      atomic_store(&(pool->bounds[p].remaining_episodes), pool->seeds_count);
+      atomic_store(&(pool->bounds[p].pruned), BHM_FALSE);
+   }
+
+   // Hand out contiguous slices of the episodes up front, stealing only balances what is left.
+   uint64_t episodes_count = (uint64_t) pool->pending_count * pool->seeds_count;
+   for (int i = 0; i < pool->workers_count; i++) {
+      uint64_t begin = episodes_count * i / pool->workers_count;
+      uint64_t end = episodes_count * (i + 1) / pool->workers_count;
+      atomic_store(&(pool->workers[i].queue), (end << 32) | begin);
+   }
+
+   pthread_mutex_lock(&(pool->lock));
+   pool->error = BHM_ERROR_NONE;
+   pool->busy_count = pool->workers_count - 1;
+   pool->generation++;
+   pthread_cond_broadcast(&(pool->work_available));
+   pthread_mutex_unlock(&(pool->lock));
+
+   // The calling thread evaluates its share too.
+   eval_worker_run(&(pool->workers[0]));
+
+   pthread_mutex_lock(&(pool->lock));
+   while (pool->busy_count > 0) {
+      pthread_cond_wait(&(pool->work_done), &(pool->lock));
+   }
+   bhm_error_code_t bhm_error = pool->error;
+   pthread_mutex_unlock(&(pool->lock));
+
+   if (bhm_error != BHM_ERROR_NONE) {
+      return bhm_error;
+   }
+
+   // All workers are idle, so their counts can be collected safely.
+   stats->ticks_count = 0;
+   for (int i = 0; i < pool->workers_count; i++) {
+      stats->ticks_count += pool->workers[i].context.ticks_count;
+      pool->workers[i].context.ticks_count = 0;
+   }
+
+   // Partial fitness of dropped cortices is never worth remembering.
+   stats->pruned_count = 0;
+   for (bhm_population_size_t p = 0; p < pool->pending_count; p++) {
+      bhm_population_size_t index = pool->pending[p];
+      if (atomic_load(&(pool->bounds[p].pruned))) {
+         stats->pruned_count++;
+      } else {
+         fitness_cache_put(&(pool->cache), pool->keys[index], population->cortices_fitness[index]);
+      }
+   }
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Writes population checkpoints to file on a thread of its own, so that evolution never waits for the disk.
+/// Populations are copied into one of two snapshots: one may be being written while the other waits for its turn.
+/// A checkpoint arriving while one is still waiting replaces it, so only the latest one is ever written.
+typedef struct {
+   bhm_population2d_t* snapshots[2];
+   int snapshots_generation[2];
+
+   // Snapshot waiting to be written and snapshot being written, -1 for none.
+   int pending;
+   int writing;
+
+   // Names of the last written files, in a ring, oldest first from [files_start].
+   int keep_count;
+   char (*files)[CHECKPOINT_NAME_LENGTH];
+   int files_start;
+   int files_length;
+
+   pthread_mutex_t lock;
+   pthread_cond_t work_available;
+   bhm_bool_t stopping;
+   pthread_t thread;
+} checkpointer_t;
+
+/// @brief Writes the provided snapshot to file, then deletes the oldest file if more than keep_count were written.
+/// @param checkpointer The checkpointer writing the snapshot.
+/// @param snapshot The snapshot to write.
+void checkpointer_write(checkpointer_t* checkpointer, int snapshot) {
+   char file_name[CHECKPOINT_NAME_LENGTH];
+   snprintf(file_name, CHECKPOINT_NAME_LENGTH, "out/pop_%d.p2d", checkpointer->snapshots_generation[snapshot]);
+   p2d_to_file(checkpointer->snapshots[snapshot], file_name);
+
+   if (checkpointer->keep_count <= 0) return;
+
+   // Make room for the new file by dropping the oldest one.
+   if (checkpointer->files_length == checkpointer->keep_count) {
+      remove(checkpointer->files[checkpointer->files_start]);
+      checkpointer->files_start = (checkpointer->files_start + 1) % checkpointer->keep_count;
+      checkpointer->files_length--;
+   }
+   int slot = (checkpointer->files_start + checkpointer->files_length) % checkpointer->keep_count;
+   memcpy(checkpointer->files[slot], file_name, CHECKPOINT_NAME_LENGTH);
+   checkpointer->files_length++;
+}
+
+/// @brief Thread routine of the checkpointer, writing snapshots as they come until stopped.
+/// @param arg The checkpointer to run.
+void* checkpointer_loop(void* arg) {
+   checkpointer_t* checkpointer = (checkpointer_t*) arg;
+
+   pthread_mutex_lock(&(checkpointer->lock));
+   for (;;) {
+      while (!checkpointer->stopping && checkpointer->pending < 0) {
+         pthread_cond_wait(&(checkpointer->work_available), &(checkpointer->lock));
+      }
+
+      // Never leave a checkpoint behind, even when stopping.
+      if (checkpointer->pending < 0) break;
+
+      checkpointer->writing = checkpointer->pending;
+      checkpointer->pending = -1;
+      pthread_mutex_unlock(&(checkpointer->lock));
+
+      checkpointer_write(checkpointer, checkpointer->writing);
+
+      pthread_mutex_lock(&(checkpointer->lock));
+      checkpointer->writing = -1;
+   }
+   pthread_mutex_unlock(&(checkpointer->lock));
+
+   return NULL;
+}
+
+/// @brief Initializes a checkpointer for populations shaped like the provided one, and starts its writer thread.
+/// @param checkpointer The checkpointer to initialize.
+/// @param population A population with the same size and cortices shape as the ones to checkpoint.
+/// @param keep_count The number of checkpoint files to keep, 0 to keep all of them.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t checkpointer_init(
+   checkpointer_t** checkpointer,
+   bhm_population2d_t* population,
+   int keep_count
+) {
+   bhm_error_code_t bhm_error;
+
+   (*checkpointer) = (checkpointer_t*) malloc(sizeof(checkpointer_t));
+   if ((*checkpointer) == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
+   }
+   (*checkpointer)->pending = -1;
+   (*checkpointer)->writing = -1;
+   (*checkpointer)->keep_count = keep_count;
+   (*checkpointer)->files_start = 0;
+   (*checkpointer)->files_length = 0;
+   (*checkpointer)->stopping = BHM_FALSE;
+   (*checkpointer)->files = NULL;
+   if (keep_count > 0) {
+      (*checkpointer)->files = malloc(keep_count * sizeof(*((*checkpointer)->files)));
+      if ((*checkpointer)->files == NULL) {
+         return BHM_ERROR_FAILED_ALLOC;
+      }
+   }
+
+   // Snapshots only need to be allocated once, their content is overwritten at every checkpoint.
+   bhm_cortex2d_t* cortex = &(population->cortices[0]);
+   for (int i = 0; i < 2; i++) {
+      bhm_error = p2d_init(
+         &((*checkpointer)->snapshots[i]),
+         population->size,
+         population->selection_pool_size,
+         POP_MUT_CHANCE,
+         &eval_cortex
+      );
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+      bhm_error = p2d_populate((*checkpointer)->snapshots[i], cortex->width, cortex->height, cortex->nh_radius);
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+      (*checkpointer)->snapshots_generation[i] = 0;
+   }
+
+   pthread_mutex_init(&((*checkpointer)->lock), NULL);
+   pthread_cond_init(&((*checkpointer)->work_available), NULL);
+   if (pthread_create(&((*checkpointer)->thread), NULL, &checkpointer_loop, *checkpointer) != 0) {
+      printf("There was an error starting the checkpointer\n");
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Waits for the last checkpoint to be written, then stops and destroys the provided checkpointer.
+/// @param checkpointer The checkpointer to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t checkpointer_destroy(checkpointer_t* checkpointer) {
+   pthread_mutex_lock(&(checkpointer->lock));
+   checkpointer->stopping = BHM_TRUE;
+   pthread_cond_signal(&(checkpointer->work_available));
+   pthread_mutex_unlock(&(checkpointer->lock));
+
+   pthread_join(checkpointer->thread, NULL);
+
+   for (int i = 0; i < 2; i++) {
+      bhm_error_code_t bhm_error = p2d_destroy(checkpointer->snapshots[i]);
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+   }
+   pthread_mutex_destroy(&(checkpointer->lock));
+   pthread_cond_destroy(&(checkpointer->work_available));
+   free(checkpointer->files);
+   free(checkpointer);
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Snapshots the provided population and hands it to the writer thread, without waiting for it to be written.
+/// @param checkpointer The checkpointer to save the population with.
+/// @param population The population to save.
+/// @param generation The generation the population is at, used to name the file.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t checkpointer_save(
+   checkpointer_t* checkpointer,
+   bhm_population2d_t* population,
+   int generation
+) {
+   // Take whichever snapshot is not being written, even if it is still waiting: this one is newer anyway.
+   pthread_mutex_lock(&(checkpointer->lock));
+   int snapshot = checkpointer->writing == 0 ? 1 : 0;
+   if (checkpointer->pending == snapshot) checkpointer->pending = -1;
+   pthread_mutex_unlock(&(checkpointer->lock));
+
+   // Copy the population, keeping the snapshot own arrays: all other fields are plain values.
+   bhm_population2d_t* target = checkpointer->snapshots[snapshot];
+   bhm_cortex2d_t* cortices = target->cortices;
+   bhm_cortex_fitness_t* cortices_fitness = target->cortices_fitness;
+   bhm_population_size_t* selection_pool = target->selection_pool;
+   *target = *population;
+   target->cortices = cortices;
+   target->cortices_fitness = cortices_fitness;
+   target->selection_pool = selection_pool;
+
+   for (bhm_population_size_t i = 0; i < population->size; i++) {
+      bhm_error_code_t bhm_error = c2d_copy(&(target->cortices[i]), &(population->cortices[i]));
+      if (bhm_error != BHM_ERROR_NONE) {
+         return bhm_error;
+      }
+   }
+   memcpy(target->cortices_fitness, population->cortices_fitness, population->size * sizeof(bhm_cortex_fitness_t));
+   memcpy(target->selection_pool, population->selection_pool, population->selection_pool_size * sizeof(bhm_population_size_t));
+   checkpointer->snapshots_generation[snapshot] = generation;
+
+   pthread_mutex_lock(&(checkpointer->lock));
+   checkpointer->pending = snapshot;
+   pthread_cond_signal(&(checkpointer->work_available));
+   pthread_mutex_unlock(&(checkpointer->lock));
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Metrics of a single evaluated generation.
+typedef struct {
+   int generation;
+   bhm_cortex_fitness_t best_fitness;
+   double mean_fitness;
+   double fitness_stddev;
+   uint64_t eval_time;
+   double ticks_per_second;
+   bhm_population_size_t cached_count;
+   bhm_population_size_t pruned_count;
+} metrics_t;
+
+/// @brief Appends per-generation metrics to a CSV file on a thread of its own.
+/// Evolution pushes records to a single producer single consumer ring without ever locking or waiting:
+/// if the writer falls behind and the ring fills up, records are dropped and counted instead.
+typedef struct {
+   metrics_t records[METRICS_QUEUE_LENGTH];
+
+   // Next record to write and next free slot, only ever moved forward by the writer and by evolution respectively.
+   _Atomic uint32_t head;
+   _Atomic uint32_t tail;
+
+   _Atomic uint32_t dropped_count;
+   _Atomic uint8_t stopping;
+
+   FILE* file;
+   pthread_t thread;
+} metrics_stream_t;
+
+/// @brief Writes all records currently in the ring of the provided stream.
+/// @param stream The stream to drain.
+void metrics_stream_drain(metrics_stream_t* stream) {
+   uint32_t head = atomic_load_explicit(&(stream->head), memory_order_relaxed);
+   uint32_t tail = atomic_load_explicit(&(stream->tail), memory_order_acquire);
+   if (head == tail) return;
+
+   for (; head != tail; head++) {
+      metrics_t* record = &(stream->records[head % METRICS_QUEUE_LENGTH]);
+      fprintf(
+         stream->file,
+         "%d,%u,%f,%f,%llu,%f,%d,%d\n",
+         record->generation,
+         (unsigned) record->best_fitness,
+         record->mean_fitness,
+         record->fitness_stddev,
+         (unsigned long long) record->eval_time,
+         record->ticks_per_second,
+         record->cached_count,
+         record->pruned_count
+      );
+   }
+   atomic_store_explicit(&(stream->head), head, memory_order_release);
+
+   // Flush every batch, so that viewers tailing the file see it right away.
+   fflush(stream->file);
+}
+
+/// @brief Thread routine of the metrics writer, periodically draining the ring until stopped.
+/// @param arg The stream to run.
+void* metrics_stream_loop(void* arg) {
+   metrics_stream_t* stream = (metrics_stream_t*) arg;
+   const struct timespec period = {
+      .tv_sec = 0,
+      .tv_nsec = METRICS_WRITE_PERIOD_MS * 1000000L
+   };
+
+   while (!atomic_load(&(stream->stopping))) {
+      metrics_stream_drain(stream);
+      nanosleep(&period, NULL);
+   }
+   metrics_stream_drain(stream);
+
+   return NULL;
+}
+
+/// @brief Opens the provided metrics file and starts writing metrics to it.
+/// @param stream The stream to initialize.
+/// @param file_name The path of the CSV file to write, truncated if already existing.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t metrics_stream_init(
+   metrics_stream_t** stream,
+   char* file_name
+) {
+   (*stream) = (metrics_stream_t*) malloc(sizeof(metrics_stream_t));
+   if ((*stream) == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
+   }
+   atomic_init(&((*stream)->head), 0);
+   atomic_init(&((*stream)->tail), 0);
+   atomic_init(&((*stream)->dropped_count), 0);
+   atomic_init(&((*stream)->stopping), BHM_FALSE);
+
+   (*stream)->file = fopen(file_name, "w");
+   if ((*stream)->file == NULL) {
+      printf("Could not open metrics file %s\n", file_name);
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+   fprintf((*stream)->file, "generation,best_fitness,mean_fitness,fitness_stddev,eval_time_ms,ticks_per_second,cached_count,pruned_count\n");
+   fflush((*stream)->file);
+
+   if (pthread_create(&((*stream)->thread), NULL, &metrics_stream_loop, *stream) != 0) {
+      printf("There was an error starting the metrics writer\n");
+      return BHM_ERROR_EXTERNAL_CAUSES;
+   }
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Writes all remaining metrics, then stops and destroys the provided stream.
+/// @param stream The stream to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t metrics_stream_destroy(metrics_stream_t* stream) {
+   atomic_store(&(stream->stopping), BHM_TRUE);
+   pthread_join(stream->thread, NULL);
+
+   uint32_t dropped_count = atomic_load(&(stream->dropped_count));
+   if (dropped_count > 0) printf("Dropped %u metrics records\n", dropped_count);
+
+   fclose(stream->file);
+   free(stream);
+
+   return BHM_ERROR_NONE;
+}
+
+/// @brief Queues the provided record for writing, dropping it if the ring is full. Never blocks.
+/// @param stream The stream to push the record to.
+/// @param record The record to push.
+void metrics_stream_push(metrics_stream_t* stream, metrics_t* record) {
+   uint32_t tail = atomic_load_explicit(&(stream->tail), memory_order_relaxed);
+   uint32_t head = atomic_load_explicit(&(stream->head), memory_order_acquire);
+   if (tail - head == METRICS_QUEUE_LENGTH) {
+      atomic_fetch_add_explicit(&(stream->dropped_count), 1, memory_order_relaxed);
+      return;
+   }
+
+   stream->records[tail % METRICS_QUEUE_LENGTH] = *record;
+   atomic_store_explicit(&(stream->tail), tail + 1, memory_order_release);
+}
+
+/// @brief Computes the fitness statistics of the provided population.
+/// @param population The evaluated population.
+/// @param record The record to write the statistics to.
+void metrics_compute_fitness(bhm_population2d_t* population, metrics_t* record) {
+   double sum = 0.0;
+   double squares_sum = 0.0;
+   record->best_fitness = 0;
+   for (bhm_population_size_t i = 0; i < population->size; i++) {
+      double fitness = (double) population->cortices_fitness[i];
+      sum += fitness;
+      squares_sum += fitness * fitness;
+      if (population->cortices_fitness[i] > record->best_fitness) record->best_fitness = population->cortices_fitness[i];
+   }
+   record->mean_fitness = sum / population->size;
+   double variance = squares_sum / population->size - record->mean_fitness * record->mean_fitness;
+   record->fitness_stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+/// @brief Everything an evolution needs, so that it can run on a thread of its own while episodes are watched from the main one.
+typedef struct {
+   bhm_population2d_t* population;
+   eval_pool_t* eval_pool;
+   checkpointer_t* checkpointer;
+   metrics_stream_t* metrics_stream;
+   int gens_count;
+   int checkpoint_interval;
+   bhm_bool_t checkpoint_on_best;
+
+   // Exit code of the evolution, only valid once over.
+   int result;
+   _Atomic bhm_bool_t over;
+} evolution_t;
+
+/// @brief Evolves the population of the provided evolution for all its generations.
+/// @param evolution The evolution to run.
+/// @return 0 on success, 1 otherwise.
+int evolution_run(evolution_t* evolution) {
+   bhm_error_code_t bhm_error;
+   bhm_population2d_t* population = evolution->population;
+   bhm_bool_t best_known = BHM_FALSE;
+   bhm_cortex_fitness_t best_fitness = 0;
+
+   for (uint16_t i = 0; i < evolution->gens_count; i++) {
+      uint64_t t0 = millis();
+      eval_stats_t eval_stats;
+      bhm_error = eval_pool_evaluate(evolution->eval_pool, population, &eval_stats);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error evaluating the cortices: %d\n", bhm_error);
+         return 1;
+      }
+      uint64_t eval_time = millis() - t0;
+      printf("Evaluated generation %d in %llu ms (%d cached, %d pruned)\n", i, (unsigned long long) eval_time, eval_stats.cached_count, eval_stats.pruned_count);
+
+      metrics_t metrics = {
+         .generation = i,
+         .eval_time = eval_time,
+         .ticks_per_second = eval_time > 0 ? eval_stats.ticks_count * 1000.0 / eval_time : 0.0,
+         .cached_count = eval_stats.cached_count,
+         .pruned_count = eval_stats.pruned_count
+      };
+      metrics_compute_fitness(population, &metrics);
+      metrics_stream_push(evolution->metrics_stream, &metrics);
+
+      bhm_error = p2d_select(population);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error selecting survivors: %d\n", bhm_error);
+         return 1;
+      }
+
+      // Checkpoint the population before crossover resets it, on a schedule, on improvements, and at the very end.
+      bhm_cortex_fitness_t generation_best = population->cortices_fitness[population->selection_pool[0]];
+      bhm_bool_t improved = !best_known || generation_best > best_fitness;
+      if (improved) {
+         best_known = BHM_TRUE;
+         best_fitness = generation_best;
+      }
+      if ((evolution->checkpoint_interval > 0 && i % evolution->checkpoint_interval == 0) ||
+          (evolution->checkpoint_on_best && improved) ||
+          i == evolution->gens_count - 1) {
+         bhm_error = checkpointer_save(evolution->checkpointer, population, i);
+         if (bhm_error != BHM_ERROR_NONE) {
+            printf("There was an error checkpointing the population: %d\n", bhm_error);
+            return 1;
+         }
+      }
+
+      printf(
+         "Best of generation %d: cortex %d with fitness %d\n",
+         i,
+         population->selection_pool[0],
+         population->cortices_fitness[population->selection_pool[0]]
+      );
+
+      #ifdef GRAPHICS
+      char cortex_string[100];
+      c2d_to_string(&(population->cortices[population->selection_pool[0]]), cortex_string);
+      printf("%s", cortex_string);
+      #endif
+
+      // Save the best cortex to file before the population is reset by crossover.
+      // char file_name[100];
+      // snprintf(file_name, 100, "out/bog_%d.c2d", i);
+      // c2d_to_file(&(population->cortices[population->selection_pool[0]]), file_name);
+
+      bhm_error = p2d_crossover(population, BHM_TRUE);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error crossing survivors over: %d\n", bhm_error);
+         return 1;
+      }
+   }
+
+   return 0;
+}
+
+/// @brief Thread routine running an evolution.
+/// @param arg The evolution to run.
+void* evolution_loop(void* arg) {
+   evolution_t* evolution = (evolution_t*) arg;
+
+   evolution->result = evolution_run(evolution);
+   atomic_store(&(evolution->over), BHM_TRUE);
+
+   return NULL;
+}
+
+int evolve(
+   int pop_size,
+   int max_eval_time,
+   int gens_count,
+   int threads_count,
+   int seeds_count,
+   int reeval_interval,
+   bhm_bool_t pruning,
+   uint64_t seed,
+   int checkpoint_interval,
+   bhm_bool_t checkpoint_on_best,
+   int checkpoint_keep_count,
+   char* metrics_file_name,
+   char* pop_file_name
+) {
+   bhm_error_code_t bhm_error;
+   bhm_population2d_t* population;
+   eval_pool_t* eval_pool;
+   checkpointer_t* checkpointer;
+   metrics_stream_t* metrics_stream;
+
+   if (pop_file_name != NULL) {
+      // ##########################################
       // Read population from file.
       // ##########################################
 
@@ -486,6 +1890,34 @@ int evolve(
       // ##########################################
    }
 
+   bhm_error = eval_pool_init(
+      &eval_pool,
+      threads_count,
+      population,
+      max_eval_time,
+      seeds_count,
+      reeval_interval,
+      pruning,
+      seed
+   );
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error initializing the evaluation pool: %d\n", bhm_error);
+      return 1;
+   }
+   printf("Evaluating on %d workers\n", eval_pool->workers_count);
+
+   bhm_error = checkpointer_init(&checkpointer, population, checkpoint_keep_count);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error initializing the checkpointer: %d\n", bhm_error);
+      return 1;
+   }
+
+   bhm_error = metrics_stream_init(&metrics_stream, metrics_file_name);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error initializing the metrics stream: %d\n", bhm_error);
+      return 1;
+   }
+
    #ifdef GRAPHICS
    InitWindow(
       WINDOW_WIDTH,
@@ -493,94 +1925,413 @@ int evolve(
       "BHM SNAKE"
    );
 
-   SetTargetFPS(960);
+   SetTargetFPS(DISPLAY_FPS);
    #endif
 
    #ifdef PLOT
-   // Start real-time plotting.
-   FILE* gnuplot_pipe = popen("gnuplot -persistent", "w");
-   
-   if (gnuplot_pipe == NULL) {
-      printf("Could not open pipe to gnuplot\n");
-      return 1;
+   // Start real-time plotting in a process of its own, which reads metrics straight from their file.
+   // gnuplot is executed directly rather than through a shell, so the file name needs no quoting.
+   pid_t plot_pid = 0;
+   char* plot_argv[] = {"gnuplot", "-c", "plot_metrics.gp", metrics_file_name, NULL};
+   if (posix_spawnp(&plot_pid, "gnuplot", NULL, NULL, plot_argv, environ) != 0) {
+      plot_pid = 0;
+      printf("Could not start gnuplot\n");
    }
-   
-   // Initial gnuplot configuration.
-   fprintf(gnuplot_pipe, "set title 'Best cortex fitness'\n");
-   fprintf(gnuplot_pipe, "set yrange [2000:10000]\n");
-   fprintf(gnuplot_pipe, "set xrange [0:%d]\n", gens_count);
-   double x_plot_data[gens_count];
-   double y_plot_data[gens_count];
    #endif
    
    // ##########################################
    // Evolve the population.
    // ##########################################
-   for (uint16_t i = 0; i < gens_count; i++) {
-      uint64_t t0 = millis();
-      bhm_error = p2d_evaluate(population);
-      if (bhm_error != BHM_ERROR_NONE) {
-         printf("There was an error evaluating the cortices: %d\n", bhm_error);
-         return 1;
+   evolution_t evolution = {
+      .population = population,
+      .eval_pool = eval_pool,
+      .checkpointer = checkpointer,
+      .metrics_stream = metrics_stream,
+      .gens_count = gens_count,
+      .checkpoint_interval = checkpoint_interval,
+      .checkpoint_on_best = checkpoint_on_best
+   };
+   atomic_init(&(evolution.over), BHM_FALSE);
+
+   #ifdef GRAPHICS
+   // Evolve on a thread of its own, while the main thread draws the episodes of all workers at display rate.
+   viewer_t viewer;
+   bhm_error = viewer_init(&viewer, &(population->cortices[0]), eval_pool->workers_count);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error initializing the viewer: %d\n", bhm_error);
+      return 1;
+   }
+   for (int i = 0; i < eval_pool->workers_count; i++) {
+      eval_pool->workers[i].context.viewer = &viewer;
+      eval_pool->workers[i].context.viewer_channel = i;
+   }
+
+   pthread_t evolution_thread;
+   if (pthread_create(&evolution_thread, NULL, &evolution_loop, &evolution) != 0) {
+      printf("There was an error starting the evolution thread\n");
+      return 1;
+   }
+
+   // Closing the window only stops watching, evolution goes on.
+   while (!atomic_load(&(evolution.over)) && !WindowShouldClose()) {
+      viewer_draw(&viewer);
+   }
+   viewer_close(&viewer);
+   CloseWindow();
+
+   pthread_join(evolution_thread, NULL);
+   viewer_destroy(&viewer);
+   #else
+   evolution_loop(&evolution);
+   #endif
+
+   #ifdef PLOT
+   // The plot loops forever, so stop it along with evolution.
+   if (plot_pid > 0) {
+      kill(plot_pid, SIGTERM);
+      waitpid(plot_pid, NULL, 0);
+   }
+   #endif
+
+   if (evolution.result != 0) {
+      return evolution.result;
+   }
+   // ##########################################
+   // ##########################################
+
+
+   // ##########################################
+   // Cleanup.
+   // ##########################################
+   metrics_stream_destroy(metrics_stream);
+   checkpointer_destroy(checkpointer);
+   eval_pool_destroy(eval_pool);
+   p2d_destroy(population);
+   // ##########################################
+   // ##########################################
+
+   return 0;
+}
+
+#ifdef GRAPHICS
+/// @brief A single episode run on a thread of its own, so that the main thread can draw it.
+typedef struct {
+   eval_context_t* context;
+   bhm_cortex2d_t* cortex;
+   uint64_t seed;
+
+   // Outcome of the episode, only valid once over.
+   bhm_cortex_fitness_t fitness;
+   bhm_error_code_t error;
+   _Atomic bhm_bool_t over;
+} replay_t;
+
+/// @brief Thread routine running a replay.
+/// @param arg The replay to run.
+void* replay_loop(void* arg) {
+   replay_t* replay = (replay_t*) arg;
+
+   replay->error = eval_cortex_in(replay->context, replay->cortex, replay->seed, NULL, NULL, &(replay->fitness));
+   atomic_store(&(replay->over), BHM_TRUE);
+
+   return NULL;
+}
+#endif
+
+/// @brief A file saved cortices are read from: either a whole population or a single cortex.
+typedef struct {
+   char* file_name;
+
+   // The population read from file, NULL if the file holds a single cortex.
+   bhm_population2d_t* population;
+
+   // The cortex read from file, NULL if the file holds a population.
+   bhm_cortex2d_t* cortex;
+} run_source_t;
+
+/// @brief Reads the cortices saved in the provided file, as a population if its name ends in ".p2d" and as a single cortex otherwise.
+/// @param source The source to read the file into.
+/// @param file_name The name of the file to read.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t run_source_read(run_source_t* source, char* file_name) {
+   size_t name_length = strlen(file_name);
+
+   source->file_name = file_name;
+   source->population = NULL;
+   source->cortex = NULL;
+
+   // Both populations and cortices must be allocated first, since reading them from file does not manage allocation by itself.
+   if (name_length >= 4 && strcmp(file_name + name_length - 4, ".p2d") == 0) {
+      source->population = (bhm_population2d_t*) malloc(sizeof(bhm_population2d_t));
+      if (source->population == NULL) {
+         return BHM_ERROR_FAILED_ALLOC;
       }
-      printf("Evaluated generation %d in %llu ms\n", i, millis() - t0);
+      return p2d_from_file(source->population, file_name);
+   }
 
-      // Save the population to file before evaluation.
-      char file_name[100];
-      snprintf(file_name, 100, "out/pop_%d.p2d", i);
-      p2d_to_file(population, file_name);
+   source->cortex = (bhm_cortex2d_t*) malloc(sizeof(bhm_cortex2d_t));
+   if (source->cortex == NULL) {
+      return BHM_ERROR_FAILED_ALLOC;
+   }
+   return c2d_from_file(source->cortex, file_name);
+}
 
-      bhm_error = p2d_select(population);
+/// @brief Scores all cortices saved in the provided files on the same seeds, all episodes running in parallel with no rendering.
+/// Per seed scores are written to a CSV file, while per cortex aggregates are printed.
+/// @param max_eval_time The maximum number of steps each episode can take.
+/// @param threads_count The number of threads running episodes, 0 for one per processor.
+/// @param seeds_count The number of episodes every cortex is scored on.
+/// @param seed The seed all scoring seeds are derived from.
+/// @param replay_seed_index The index of the seed to replay the best cortex on once scoring is over, negative for none.
+/// @param results_file_name The name of the CSV file to write per seed scores to.
+/// @param file_names The names of the files to read cortices from.
+/// @param files_count The number of files to read cortices from.
+/// @return 0 on success, 1 otherwise.
+int run(
+   int max_eval_time,
+   int threads_count,
+   int seeds_count,
+   uint64_t seed,
+   int replay_seed_index,
+   char* results_file_name,
+   char** file_names,
+   int files_count
+) {
+   bhm_error_code_t bhm_error;
+   eval_pool_t* eval_pool;
+
+   if (files_count <= 0) {
+      printf("No cortex or population file provided\n");
+      return 1;
+   }
+   if (seeds_count <= 0) seeds_count = 1;
+
+   // ##########################################
+   // Read cortices from file.
+   // ##########################################
+   run_source_t* sources = (run_source_t*) malloc(files_count * sizeof(run_source_t));
+   if (sources == NULL) {
+      printf("There was an error allocating the cortex sources\n");
+      return 1;
+   }
+
+   size_t cortices_count = 0;
+   for (int i = 0; i < files_count; i++) {
+      bhm_error = run_source_read(&(sources[i]), file_names[i]);
       if (bhm_error != BHM_ERROR_NONE) {
-         printf("There was an error selecting survivors: %d\n", bhm_error);
+         printf("There was an error reading file %s: %d\n", file_names[i], bhm_error);
          return 1;
       }
+      cortices_count += sources[i].population != NULL ? sources[i].population->size : 1;
+   }
+   if (cortices_count == 0 || cortices_count > (bhm_population_size_t) ~((bhm_population_size_t) 0)) {
+      printf("Cannot score %zu cortices at once\n", cortices_count);
+      return 1;
+   }
 
-      #ifdef PLOT
-      x_plot_data[i] = i;
-      y_plot_data[i] = population->cortices_fitness[population->selection_pool[0]];
-
-      // Plot data.
-      if (i % 1000 == 0) {
-         // Tell gnuplot to plot data from standard input ('-').
-         fprintf(gnuplot_pipe, "plot '-' with lines title 'Signal'\n");
+   // Gather all cortices into a single population, so that their episodes are all balanced over the same workers.
+   // The population only borrows the cortices, which stay owned by their sources.
+   bhm_population2d_t scored = {
+      .size = (bhm_population_size_t) cortices_count,
+      .selection_pool_size = 1,
+      .cortices = (bhm_cortex2d_t*) malloc(cortices_count * sizeof(bhm_cortex2d_t)),
+      .cortices_fitness = (bhm_cortex_fitness_t*) malloc(cortices_count * sizeof(bhm_cortex_fitness_t)),
+      .selection_pool = NULL
+   };
+   run_source_t** cortices_source = (run_source_t**) malloc(cortices_count * sizeof(run_source_t*));
+   bhm_population_size_t* cortices_index = (bhm_population_size_t*) malloc(cortices_count * sizeof(bhm_population_size_t));
+   if (scored.cortices == NULL || scored.cortices_fitness == NULL || cortices_source == NULL || cortices_index == NULL) {
+      printf("There was an error allocating the scored population\n");
+      return 1;
+   }
 
-         // Send the raw X/Y data directly through the pipe.
-         for (int j = 0; j <= i; j++) {
-            fprintf(gnuplot_pipe, "%f %f\n", x_plot_data[j], y_plot_data[j]);
+   bhm_population_size_t c = 0;
+   for (int i = 0; i < files_count; i++) {
+      bhm_population_size_t size = sources[i].population != NULL ? sources[i].population->size : 1;
+      for (bhm_population_size_t j = 0; j < size; j++, c++) {
+         scored.cortices[c] = sources[i].population != NULL ? sources[i].population->cortices[j] : *(sources[i].cortex);
+         cortices_source[c] = &(sources[i]);
+         cortices_index[c] = j;
+
+         // Evaluation resources are shared by all cortices, so they all need the same shape.
+         if (scored.cortices[c].width != scored.cortices[0].width ||
+             scored.cortices[c].height != scored.cortices[0].height ||
+             scored.cortices[c].nh_radius != scored.cortices[0].nh_radius) {
+            printf("Cortex %d of file %s is not shaped like the others\n", j, sources[i].file_name);
+            return 1;
          }
+      }
+   }
+   // ##########################################
+   // ##########################################
+
+
+   // ##########################################
+   // Score cortices.
+   // ##########################################
+   // Scores are only meaningful as a whole, so neither cache nor prune anything.
+   bhm_error = eval_pool_init(
+      &eval_pool,
+      threads_count,
+      &scored,
+      max_eval_time,
+      seeds_count,
+      0,
+      BHM_FALSE,
+      seed
+   );
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error initializing the evaluation pool: %d\n", bhm_error);
+      return 1;
+   }
 
-         // Send the 'e' character to tell gnuplot the data block is finished.
-         fprintf(gnuplot_pipe, "e\n");
-         
-         // Flush the pipe to ensure the commands are executed immediately.
-         fflush(gnuplot_pipe);
+   printf("Scoring %zu cortices on %d seeds with %d workers\n", cortices_count, seeds_count, eval_pool->workers_count);
+
+   uint64_t t0 = millis();
+   eval_stats_t eval_stats;
+   bhm_error = eval_pool_evaluate(eval_pool, &scored, &eval_stats);
+   if (bhm_error != BHM_ERROR_NONE) {
+      printf("There was an error scoring the cortices: %d\n", bhm_error);
+      return 1;
+   }
+   uint64_t eval_time = millis() - t0;
+   // ##########################################
+   // ##########################################
+
+
+   // ##########################################
+   // Report scores.
+   // ##########################################
+   FILE* results_file = fopen(results_file_name, "w");
+   if (results_file == NULL) {
+      printf("There was an error opening the results file %s\n", results_file_name);
+      return 1;
+   }
+   fprintf(results_file, "file,cortex,seed,fitness\n");
+
+   bhm_population_size_t best = 0;
+   for (bhm_population_size_t p = 0; p < eval_pool->pending_count; p++) {
+      bhm_population_size_t index = eval_pool->pending[p];
+      bhm_cortex_fitness_t* episodes_fitness = &(eval_pool->episodes_fitness[(size_t) p * seeds_count]);
+
+      bhm_cortex_fitness_t min_fitness = episodes_fitness[0];
+      bhm_cortex_fitness_t max_fitness = episodes_fitness[0];
+      double mean = 0.0;
+      for (int s = 0; s < seeds_count; s++) {
+         fprintf(
+            results_file,
+            "%s,%d,%llu,%llu\n",
+            cortices_source[index]->file_name,
+            cortices_index[index],
+            (unsigned long long) eval_pool->eval_seeds[s],
+            (unsigned long long) episodes_fitness[s]
+         );
+         if (episodes_fitness[s] < min_fitness) min_fitness = episodes_fitness[s];
+         if (episodes_fitness[s] > max_fitness) max_fitness = episodes_fitness[s];
+         mean += episodes_fitness[s];
+      }
+      mean /= seeds_count;
+
+      double variance = 0.0;
+      for (int s = 0; s < seeds_count; s++) {
+         variance += (episodes_fitness[s] - mean) * (episodes_fitness[s] - mean);
       }
-      #endif
 
       printf(
-         "Best of generation %d: cortex %d with fitness %d\n",
-         i,
-         population->selection_pool[0],
-         population->cortices_fitness[population->selection_pool[0]]
+         "%s [%d]: mean %.2f, stddev %.2f, min %llu, max %llu\n",
+         cortices_source[index]->file_name,
+         cortices_index[index],
+         mean,
+         sqrt(variance / seeds_count),
+         (unsigned long long) min_fitness,
+         (unsigned long long) max_fitness
       );
 
+      if (scored.cortices_fitness[index] > scored.cortices_fitness[best]) best = index;
+   }
+   fclose(results_file);
+
+   printf(
+      "Scored %zu episodes in %llu ms (%.0f ticks/s), per seed scores written to %s\n",
+      cortices_count * seeds_count,
+      (unsigned long long) eval_time,
+      eval_time > 0 ? eval_stats.ticks_count * 1000.0 / eval_time : 0.0,
+      results_file_name
+   );
+   printf(
+      "Best cortex: %s [%d] with fitness %llu\n",
+      cortices_source[best]->file_name,
+      cortices_index[best],
+      (unsigned long long) scored.cortices_fitness[best]
+   );
+   // ##########################################
+   // ##########################################
+
+
+   // ##########################################
+   // Replay the best cortex.
+   // ##########################################
+   if (replay_seed_index >= seeds_count) {
+      printf("There is no seed %d to replay, only %d were scored\n", replay_seed_index, seeds_count);
+   } else if (replay_seed_index >= 0) {
       #ifdef GRAPHICS
-      char cortex_string[100];
-      c2d_to_string(&(population->cortices[population->selection_pool[0]]), cortex_string);
-      printf("%s", cortex_string);
-      #endif
+      eval_context_t context;
+      bhm_error = eval_context_init(&context, &(scored.cortices[best]), max_eval_time);
+      if (bhm_error != BHM_ERROR_NONE) {
+         printf("There was an error initializing the replay context: %d\n", bhm_error);
+         return 1;
+      }
 
-      // Save the best cortex to file before the population is reset by crossover.
-      // char file_name[100];
-      // snprintf(file_name, 100, "out/bog_%d.c2d", i);
-      // c2d_to_file(&(population->cortices[population->selection_pool[0]]), file_name);
+      InitWindow(
+         WINDOW_WIDTH,
+         WINDOW_HEIGHT,
+         "BHM SNAKE"
+      );
+      SetTargetFPS(DISPLAY_FPS);
 
-      bhm_error = p2d_crossover(population, BHM_TRUE);
+      viewer_t viewer;
+      bhm_error = viewer_init(&viewer, &(scored.cortices[best]), 1);
       if (bhm_error != BHM_ERROR_NONE) {
-         printf("There was an error crossing survivors over: %d\n", bhm_error);
+         printf("There was an error initializing the viewer: %d\n", bhm_error);
+         return 1;
+      }
+      context.viewer = &viewer;
+      context.step_period = 1000000000L / REPLAY_STEPS_PER_SECOND;
+
+      // Episodes only depend on cortex and seed, so the replay is the very episode that was scored.
+      replay_t replay = {
+         .context = &context,
+         .cortex = &(scored.cortices[best]),
+         .seed = eval_pool->eval_seeds[replay_seed_index]
+      };
+      atomic_init(&(replay.over), BHM_FALSE);
+
+      pthread_t replay_thread;
+      if (pthread_create(&replay_thread, NULL, &replay_loop, &replay) != 0) {
+         printf("There was an error starting the replay thread\n");
          return 1;
       }
+
+      // Closing the window stops pacing the replay, which then runs to its end right away.
+      while (!atomic_load(&(replay.over)) && !WindowShouldClose()) {
+         viewer_draw(&viewer);
+      }
+      viewer_close(&viewer);
+      CloseWindow();
+
+      pthread_join(replay_thread, NULL);
+      viewer_destroy(&viewer);
+
+      if (replay.error != BHM_ERROR_NONE) {
+         printf("There was an error replaying the best cortex: %d\n", replay.error);
+         return 1;
+      }
+      printf("Replayed seed %d with fitness %llu\n", replay_seed_index, (unsigned long long) replay.fitness);
+
+      eval_context_destroy(&context);
+      #else
+      printf("Replays are only rendered in GRAPHICS builds\n");
+      #endif
    }
    // ##########################################
    // ##########################################
@@ -589,15 +2340,19 @@ int evolve(
    // ##########################################
    // Cleanup.
    // ##########################################
-   #ifdef GRAPHICS
-   CloseWindow();
-   #endif
-
-   #ifdef PLOT
-   pclose(gnuplot_pipe);
-   #endif
-
-   p2d_destroy(population);
+   eval_pool_destroy(eval_pool);
+   free(scored.cortices);
+   free(scored.cortices_fitness);
+   free(cortices_source);
+   free(cortices_index);
+   for (int i = 0; i < files_count; i++) {
+      if (sources[i].population != NULL) {
+         p2d_destroy(sources[i].population);
+      } else {
+         c2d_destroy(sources[i].cortex);
+      }
+   }
+   free(sources);
    // ##########################################
    // ##########################################
 
@@ -609,6 +2364,25 @@ struct option evolve_options[] = {
    {"max_eval_time", required_argument, 0, 't'},
    {"gens_count", required_argument, 0, 'g'},
    {"pop_file_path", required_argument, 0, 'f'},
+   {"threads_count", required_argument, 0, 'j'},
+   {"seeds_count", required_argument, 0, 'k'},
+   {"reeval_interval", required_argument, 0, 'r'},
+   {"pruning", required_argument, 0, 'p'},
+   {"seed", required_argument, 0, 'S'},
+   {"checkpoint_interval", required_argument, 0, 'c'},
+   {"checkpoint_on_best", required_argument, 0, 'b'},
+   {"checkpoint_keep_count", required_argument, 0, 'K'},
+   {"metrics_file_path", required_argument, 0, 'm'},
+   {0, no_argument, 0, 0}
+};
+
+struct option run_options[] = {
+   {"max_eval_time", required_argument, 0, 't'},
+   {"threads_count", required_argument, 0, 'j'},
+   {"seeds_count", required_argument, 0, 'k'},
+   {"seed", required_argument, 0, 'S'},
+   {"replay_seed", required_argument, 0, 'R'},
+   {"results_file_path", required_argument, 0, 'o'},
    {0, no_argument, 0, 0}
 };
 
@@ -630,6 +2404,15 @@ int main(int argc, char** argv) {
       int pop_size = POP_SIZE;
       int max_eval_time = MAX_EVAL_TIME;
       int gens_count = GENERATIONS_COUNT;
+      int threads_count = EVAL_THREADS_COUNT;
+      int seeds_count = EVAL_SEEDS_COUNT;
+      int reeval_interval = REEVAL_INTERVAL;
+      int pruning = EVAL_PRUNING;
+      uint64_t seed = (uint64_t) time(NULL);
+      int checkpoint_interval = CHECKPOINT_INTERVAL;
+      int checkpoint_on_best = CHECKPOINT_ON_BEST;
+      int checkpoint_keep_count = CHECKPOINT_KEEP_COUNT;
+      char* metrics_file_path = METRICS_FILE_NAME;
       char* pop_file_path = NULL;
 
       int opt;
@@ -650,6 +2433,33 @@ int main(int argc, char** argv) {
             case 'f':
                pop_file_path = optarg;
                break;
+            case 'j':
+               threads_count = atoi(optarg);
+               break;
+            case 'k':
+               seeds_count = atoi(optarg);
+               break;
+            case 'r':
+               reeval_interval = atoi(optarg);
+               break;
+            case 'p':
+               pruning = atoi(optarg);
+               break;
+            case 'S':
+               seed = strtoull(optarg, NULL, 10);
+               break;
+            case 'c':
+               checkpoint_interval = atoi(optarg);
+               break;
+            case 'b':
+               checkpoint_on_best = atoi(optarg);
+               break;
+            case 'K':
+               checkpoint_keep_count = atoi(optarg);
+               break;
+            case 'm':
+               metrics_file_path = optarg;
+               break;
             case '?':
                printf("Unknown option or missing value.\n");
                return 1;
@@ -658,13 +2468,22 @@ int main(int argc, char** argv) {
          }
       }
 
-      printf("Running evolve with pop_size %d, max_eval_time %d, gens_count %d, pop_file_path %s\n", pop_size, max_eval_time, gens_count, pop_file_path);
+      printf("Running evolve with pop_size %d, max_eval_time %d, gens_count %d, threads_count %d, seeds_count %d, reeval_interval %d, pruning %d, seed %llu, pop_file_path %s\n", pop_size, max_eval_time, gens_count, threads_count, seeds_count, reeval_interval, pruning, (unsigned long long) seed, pop_file_path);
 
       // Evolve.
       return evolve(
          pop_size,
          max_eval_time,
          gens_count,
+         threads_count,
+         seeds_count,
+         reeval_interval,
+         pruning != 0,
+         seed,
+         checkpoint_interval,
+         checkpoint_on_best != 0,
+         checkpoint_keep_count,
+         metrics_file_path,
          pop_file_path
       );
    }
@@ -679,17 +2498,84 @@ int main(int argc, char** argv) {
       printf("\t\t--pop_size [default 20] - sets the size of the population to evolve.\n");
       printf("\t\t--max_eval_time [default 10000] - sets the maximum number of steps each evaluation can take.\n");
       printf("\t\t--gens_count [default 10000] - sets how many generations to evolve for.\n");
+      printf("\t\t--threads_count [default 0] - sets how many threads evaluate cortices in parallel, 0 for one per processor.\n");
+      printf("\t\t--seeds_count [default 4] - sets how many episodes every cortex is evaluated on, all cortices sharing the same seeds.\n");
+      printf("\t\t--reeval_interval [default 10] - sets how many generations are evaluated on the same seeds before moving to new ones, 0 for never.\n");
+      printf("\t\t--pruning [default 1] - sets whether to stop evaluating cortices as soon as they cannot make it into the selection pool anymore.\n");
+      printf("\t\t--seed [default current time] - sets the seed all evaluation seeds are derived from.\n");
+      printf("\t\t--checkpoint_interval [default 10] - sets how many generations pass between two population checkpoints, 0 for none but the ones on improvements.\n");
+      printf("\t\t--checkpoint_on_best [default 1] - sets whether to also checkpoint the population whenever the best fitness improves.\n");
+      printf("\t\t--checkpoint_keep_count [default 5] - sets how many checkpoint files to keep, 0 for all of them.\n");
+      printf("\t\t--metrics_file_path [default out/metrics.csv] - sets the CSV file per generation metrics are appended to.\n");
       printf("\t\t--pop_file_path - Tells the program to evolve an existing population from file. If --pop_file_path is provided, --pop_size is ignored.\n");
       printf("\n");
+      printf("run [files] - scores the cortices saved in the provided files, whole populations if ending in .p2d and single cortices otherwise, all on the same seeds.\n");
+      printf("\tAvailable parameters:\n");
+      printf("\t\t--max_eval_time [default 10000] - sets the maximum number of steps each episode can take.\n");
+      printf("\t\t--threads_count [default 0] - sets how many threads run episodes in parallel, 0 for one per processor.\n");
+      printf("\t\t--seeds_count [default 100] - sets how many episodes every cortex is scored on.\n");
+      printf("\t\t--seed [default 0] - sets the seed all scoring seeds are derived from.\n");
+      printf("\t\t--replay_seed [default -1] - sets the index of the seed to replay the best cortex on once scoring is over, -1 for none. Only GRAPHICS builds render replays.\n");
+      printf("\t\t--results_file_path [default out/run.csv] - sets the CSV file per seed scores are written to.\n");
+      printf("\n");
       printf("help - shows this help text.\n");
       printf("\n");
       return 0;
    }
 
    if (strcmp(argv[1], "run") == 0) {
-      // TODO.
-      printf("Unimplemented\n");
-      return 0;
+      int max_eval_time = MAX_EVAL_TIME;
+      int threads_count = EVAL_THREADS_COUNT;
+      int seeds_count = RUN_SEEDS_COUNT;
+      uint64_t seed = RUN_SEED;
+      int replay_seed = -1;
+      char* results_file_path = RUN_RESULTS_FILE_NAME;
+
+      int opt;
+      int option_index = 0;
+
+      // Loop through all arguments, leaving the names of the files to read at the end.
+      while ((opt = getopt_long(argc - 1, argv + 1, "", run_options, &option_index)) != -1) {
+         switch (opt) {
+            case 't':
+               max_eval_time = atoi(optarg);
+               break;
+            case 'j':
+               threads_count = atoi(optarg);
+               break;
+            case 'k':
+               seeds_count = atoi(optarg);
+               break;
+            case 'S':
+               seed = strtoull(optarg, NULL, 10);
+               break;
+            case 'R':
+               replay_seed = atoi(optarg);
+               break;
+            case 'o':
+               results_file_path = optarg;
+               break;
+            case '?':
+               printf("Unknown option or missing value.\n");
+               return 1;
+            default:
+               abort();
+         }
+      }
+
+      printf("Running run with max_eval_time %d, threads_count %d, seeds_count %d, seed %llu, replay_seed %d, results_file_path %s\n", max_eval_time, threads_count, seeds_count, (unsigned long long) seed, replay_seed, results_file_path);
+
+      // Score.
+      return run(
+         max_eval_time,
+         threads_count,
+         seeds_count,
+         seed,
+         replay_seed,
+         results_file_path,
+         argv + 1 + optind,
+         argc - 1 - optind
+      );
    }
    // ##########################################
    // ##########################################
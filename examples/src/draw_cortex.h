@@ -1,7 +1,46 @@
 #include <raylib.h>
 #include <behema/behema.h>
 
+// Renders a cortex through a texture holding one texel per neuron, drawn with a single scaled quad.
+// Neurons change at every tick, so the whole texture is uploaded every frame, which is still a single upload.
+typedef struct {
+    // Size of the texture, the one of the last drawn cortex.
+    bhm_cortex_size_t width;
+    bhm_cortex_size_t height;
+
+    Color* pixels;
+    Texture2D texture;
+} cortex_renderer_t;
+
+/// @brief Initializes the provided renderer.
+/// The texture is only created when first drawing, so the window does not need to be open yet.
+/// @param renderer The renderer to initialize.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t cortex_renderer_init(cortex_renderer_t* renderer) {
+    renderer->width = 0;
+    renderer->height = 0;
+    renderer->pixels = NULL;
+    renderer->texture = (Texture2D) {0};
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Releases the texture and buffer of the provided renderer. Must be called before closing the window.
+/// @param renderer The renderer to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t cortex_renderer_destroy(cortex_renderer_t* renderer) {
+    if (renderer->texture.id != 0) {
+        UnloadTexture(renderer->texture);
+        renderer->texture = (Texture2D) {0};
+    }
+    free(renderer->pixels);
+    renderer->pixels = NULL;
+
+    return BHM_ERROR_NONE;
+}
+
 bhm_error_code_t draw_cortex(
+    cortex_renderer_t* renderer,
     bhm_cortex2d_t* cortex,
     int window_width,
     int window_height
@@ -12,7 +51,27 @@ bhm_error_code_t draw_cortex(
     const int starting_x = window_width - cortex->width * cell_width;
     const int starting_y = 0;
 
-    // ClearBackground(BLACK);
+    // (Re)create the texture whenever the cortex size changes, the first frame included.
+    if (renderer->texture.id == 0 || renderer->width != cortex->width || renderer->height != cortex->height) {
+        cortex_renderer_destroy(renderer);
+
+        renderer->width = cortex->width;
+        renderer->height = cortex->height;
+        renderer->pixels = (Color*) calloc((size_t) cortex->width * cortex->height, sizeof(Color));
+        if (renderer->pixels == NULL) {
+            return BHM_ERROR_FAILED_ALLOC;
+        }
+
+        Image image = {
+            .data = renderer->pixels,
+            .width = renderer->width,
+            .height = renderer->height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+        };
+        renderer->texture = LoadTextureFromImage(image);
+        SetTextureFilter(renderer->texture, TEXTURE_FILTER_POINT);
+    }
 
     for (bhm_cortex_size_t i = 0; i < cortex->height; i++) {
         for (bhm_cortex_size_t j = 0; j < cortex->width; j++) {
@@ -45,16 +104,20 @@ bhm_error_code_t draw_cortex(
                 }
             }
 
-            DrawRectangle(
-                starting_x + j * cell_width,
-                starting_y + i * cell_height,
-                cell_width,
-                cell_height,
-                neuron_color
-            );
+            renderer->pixels[IDX2D(j, i, cortex->width)] = neuron_color;
         }
     }
 
+    UpdateTexture(renderer->texture, renderer->pixels);
+    DrawTexturePro(
+        renderer->texture,
+        (Rectangle) {0, 0, renderer->width, renderer->height},
+        (Rectangle) {starting_x, starting_y, renderer->width * cell_width, renderer->height * cell_height},
+        (Vector2) {0, 0},
+        0.0f,
+        WHITE
+    );
+
     // Draw cortex info.
     const int text_padding = 8;
     const int font_size = 20;
@@ -2,91 +2,287 @@
 #include <snaken/snaken.h>
 #include <snaken/utils.h>
 
-snaken_error_code_t draw_snaken(
+// Everything needed to draw a world, detached from the world itself so that it can be drawn while the world keeps going.
+typedef struct {
+    snaken_world_size_t width;
+    snaken_world_size_t height;
+
+    // Color of every cell, as rasterized by [snaken2d_render_rgb].
+    uint8_t* cells;
+
+    snaken_world_size_t snake_length;
+    snaken_snake_speed_t snake_speed;
+    snaken_snake_speed_t snake_speed_step;
+    snaken_snake_stamina_t snake_stamina;
+    snaken_snake_stamina_t snake_stamina_step;
+    snaken_bool_t snake_alive;
+
+    // Number of the episode the world is in, maintained by whoever captures it, so that resets can be told apart.
+    uint64_t episode;
+} snaken_frame_t;
+
+/// @brief Initializes the provided frame for worlds of the provided size.
+/// @param frame The frame to initialize.
+/// @param width The width of the worlds to capture.
+/// @param height The height of the worlds to capture.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_frame_init(
+    snaken_frame_t* frame,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+) {
+    frame->width = width;
+    frame->height = height;
+    frame->snake_length = 0;
+    frame->snake_speed = 0;
+    frame->snake_speed_step = 0;
+    frame->snake_stamina = 0;
+    frame->snake_stamina_step = 0;
+    frame->snake_alive = SNAKEN_TRUE;
+    frame->episode = 0;
+    frame->cells = (uint8_t*) calloc((size_t) width * height, SNAKEN_RGB_CHANNELS);
+    if (frame->cells == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Destroys the content of the provided frame.
+/// @param frame The frame to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_frame_destroy(snaken_frame_t* frame) {
+    free(frame->cells);
+    frame->cells = NULL;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Captures the current state of the provided world into the provided frame.
+/// @param frame The frame to capture the world into, sized like the world.
+/// @param snaken The world to capture.
+/// @param palette The colors to capture cells with, NULL for the default ones.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none, [SNAKEN_ERROR_INVALID_SIZE] if frame and world differ in size.
+snaken_error_code_t snaken_frame_capture(
+    snaken_frame_t* frame,
     snaken2d_t* snaken,
-    int window_width,
-    int window_height
+    snaken_palette_t* palette
 ) {
-    const int cell_width = window_width / snaken->world_width;
-    const int cell_height = window_height / snaken->world_height;
-    const Color snake_head_color = (Color) {0x7F, 0xFF, 0x55, 0xFF};
-    const Color snake_tail_color = (Color) {0x11, 0x33, 0x44, 0xFF};
-    const Color apple_color = (Color) {0xFF, 0x5A, 0x5A, 0xFF};
-    const Color wall_color = (Color) {0xFF, 0xFF, 0xFF, 0xFF};
-
-    // Draw snake (tail to head in order to always show the head on top).
-    for (int i = snaken->snake_length - 1; i >= 0; i--) {
-        snaken_world_size_t section_location_x = snaken->snake_body[i] % snaken->world_width;
-        snaken_world_size_t section_location_y = snaken->snake_body[i] / snaken->world_width;
-
-        double segment_position = ((double) i) / (snaken->snake_length - 1);
-
-        Color segment_color = (Color) {
-            lerp(snake_head_color.r, snake_tail_color.r, segment_position),
-            lerp(snake_head_color.g, snake_tail_color.g, segment_position),
-            lerp(snake_head_color.b, snake_tail_color.b, segment_position),
-            0xFF
-        };
+    if (frame->width != snaken->world_width || frame->height != snaken->world_height) {
+        return SNAKEN_ERROR_INVALID_SIZE;
+    }
 
-        DrawRectangle(
-            section_location_x * cell_width,
-            section_location_y * cell_height,
-            cell_width, cell_height,
-            segment_color
-        );
+    frame->snake_length = snaken->snake_length;
+    frame->snake_speed = snaken->snake_speed;
+    frame->snake_speed_step = snaken->snake_speed_step;
+    frame->snake_stamina = snaken->snake_stamina;
+    frame->snake_stamina_step = snaken->snake_stamina_step;
+    frame->snake_alive = snaken->snake_alive;
+
+    // One texel per cell is all the renderer needs, and is cheap enough to capture at every tick.
+    return snaken2d_render_rgb(snaken, 1, palette, frame->cells);
+}
+
+// Renders worlds through a texture holding one texel per cell, so that every frame only uploads the cells changed since the last one
+// and draws the whole world with a single scaled quad, no matter how large it is.
+typedef struct {
+    snaken_palette_t palette;
+
+    // Size of the texture, the one of the last drawn frame.
+    snaken_world_size_t width;
+    snaken_world_size_t height;
+
+    // Cells as currently held by the texture.
+    uint8_t* uploaded;
+
+    // Frame worlds are captured into when drawn directly.
+    snaken_frame_t frame;
+
+    Texture2D texture;
+} snaken_renderer_t;
+
+/// @brief Initializes the provided renderer with the default palette.
+/// The texture is only created when first drawing, so the window does not need to be open yet.
+/// @param renderer The renderer to initialize.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_renderer_init(snaken_renderer_t* renderer) {
+    snaken_palette_init(&(renderer->palette));
+    renderer->width = 0;
+    renderer->height = 0;
+    renderer->uploaded = NULL;
+    renderer->frame = (snaken_frame_t) {0};
+    renderer->texture = (Texture2D) {0};
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Releases the texture and buffers of the provided renderer. Must be called before closing the window.
+/// @param renderer The renderer to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_renderer_destroy(snaken_renderer_t* renderer) {
+    if (renderer->texture.id != 0) {
+        UnloadTexture(renderer->texture);
+        renderer->texture = (Texture2D) {0};
     }
+    free(renderer->uploaded);
+    renderer->uploaded = NULL;
+    snaken_frame_destroy(&(renderer->frame));
 
-    // Draw walls.
-    for (int i = 0; i < snaken->walls_length; i++) {
-        snaken_world_size_t wall_location_x = snaken->walls[i] % snaken->world_width;
-        snaken_world_size_t wall_location_y = snaken->walls[i] / snaken->world_width;
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Uploads the cells of the provided frame that differ from the ones held by the texture, at the provided texture location.
+/// A row with changes only uploads the span between its first and last changed cells, while runs of changed rows are uploaded
+/// as a single band as wide as the frame, so that a frame takes as few uploads as the changes allow.
+/// @param texture The texture to upload to.
+/// @param uploaded The content of the texture, starting at the frame location.
+/// @param uploaded_stride The distance in bytes between two rows of the texture content.
+/// @param x The x location of the frame in the texture.
+/// @param y The y location of the frame in the texture.
+/// @param frame The frame to upload.
+void snaken_frame_upload(
+    Texture2D texture,
+    uint8_t* uploaded,
+    size_t uploaded_stride,
+    int x,
+    int y,
+    snaken_frame_t* frame
+) {
+    const size_t row_size = (size_t) frame->width * SNAKEN_RGB_CHANNELS;
+
+    for (snaken_world_size_t j = 0; j < frame->height;) {
+        uint8_t* frame_row = frame->cells + j * row_size;
+        uint8_t* uploaded_row = uploaded + j * uploaded_stride;
+
+        if (memcmp(frame_row, uploaded_row, row_size) == 0) {
+            j++;
+            continue;
+        }
+
+        // Extend the run over all following changed rows.
+        snaken_world_size_t band_end = j + 1;
+        while (band_end < frame->height &&
+               memcmp(frame->cells + band_end * row_size, uploaded + band_end * uploaded_stride, row_size) != 0) {
+            band_end++;
+        }
+
+        if (band_end - j > 1) {
+            // Frame rows are contiguous, so the band is already packed as uploads expect.
+            UpdateTextureRec(
+                texture,
+                (Rectangle) {x, y + j, frame->width, band_end - j},
+                frame_row
+            );
+            for (snaken_world_size_t k = j; k < band_end; k++) {
+                memcpy(uploaded + k * uploaded_stride, frame->cells + k * row_size, row_size);
+            }
+        } else {
+            snaken_world_size_t x0 = 0;
+            while (memcmp(frame_row + x0 * SNAKEN_RGB_CHANNELS, uploaded_row + x0 * SNAKEN_RGB_CHANNELS, SNAKEN_RGB_CHANNELS) == 0) x0++;
+            snaken_world_size_t x1 = frame->width - 1;
+            while (memcmp(frame_row + x1 * SNAKEN_RGB_CHANNELS, uploaded_row + x1 * SNAKEN_RGB_CHANNELS, SNAKEN_RGB_CHANNELS) == 0) x1--;
+
+            UpdateTextureRec(
+                texture,
+                (Rectangle) {x + x0, y + j, x1 - x0 + 1, 1},
+                frame_row + x0 * SNAKEN_RGB_CHANNELS
+            );
+            memcpy(uploaded_row + x0 * SNAKEN_RGB_CHANNELS, frame_row + x0 * SNAKEN_RGB_CHANNELS, (x1 - x0 + 1) * SNAKEN_RGB_CHANNELS);
+        }
 
-        DrawRectangle(wall_location_x * cell_width, wall_location_y * cell_height, cell_width, cell_height, wall_color);
+        j = band_end;
     }
+}
 
-    // Draw apples.
-    for (int i = 0; i < snaken->apples_length; i++) {
-        snaken_world_size_t apple_location_x = snaken->apples[i] % snaken->world_width;
-        snaken_world_size_t apple_location_y = snaken->apples[i] / snaken->world_width;
+/// @brief Draws a previously captured world, which can be captured by another thread.
+/// @param renderer The renderer to draw with.
+/// @param frame The frame to draw.
+/// @param window_width The width of the window.
+/// @param window_height The height of the window.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t draw_snaken_frame(
+    snaken_renderer_t* renderer,
+    snaken_frame_t* frame,
+    int window_width,
+    int window_height
+) {
+    const int cell_width = window_width / frame->width;
+    const int cell_height = window_height / frame->height;
 
-        DrawRectangle(apple_location_x * cell_width, apple_location_y * cell_height, cell_width, cell_height, apple_color);
+    // (Re)create the texture whenever the frame size changes, the first frame included.
+    if (renderer->texture.id == 0 || renderer->width != frame->width || renderer->height != frame->height) {
+        if (renderer->texture.id != 0) {
+            UnloadTexture(renderer->texture);
+        }
+        free(renderer->uploaded);
+
+        const size_t frame_size = (size_t) frame->width * frame->height * SNAKEN_RGB_CHANNELS;
+        renderer->width = frame->width;
+        renderer->height = frame->height;
+        renderer->uploaded = (uint8_t*) malloc(frame_size);
+        if (renderer->uploaded == NULL) {
+            renderer->texture = (Texture2D) {0};
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+        memcpy(renderer->uploaded, frame->cells, frame_size);
+
+        Image image = {
+            .data = renderer->uploaded,
+            .width = renderer->width,
+            .height = renderer->height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8
+        };
+        renderer->texture = LoadTextureFromImage(image);
+        SetTextureFilter(renderer->texture, TEXTURE_FILTER_POINT);
     }
 
+    snaken_frame_upload(renderer->texture, renderer->uploaded, (size_t) renderer->width * SNAKEN_RGB_CHANNELS, 0, 0, frame);
+
+    DrawTexturePro(
+        renderer->texture,
+        (Rectangle) {0, 0, renderer->width, renderer->height},
+        (Rectangle) {0, 0, renderer->width * cell_width, renderer->height * cell_height},
+        (Vector2) {0, 0},
+        0.0f,
+        WHITE
+    );
+
     const int font_size = 20;
     const int text_padding_x = 8;
     const int text_padding_y = 8;
 
     // Draw snake length.
     DrawText(
-        TextFormat("Length: %i", snaken->snake_length),
+        TextFormat("Length: %i", frame->snake_length),
         text_padding_x,
         text_padding_y,
         font_size,
         RAYWHITE
     );
     DrawText(
-        TextFormat("speed: %i", snaken->snake_speed),
+        TextFormat("speed: %i", frame->snake_speed),
         text_padding_x,
         text_padding_y + font_size,
         font_size,
         RAYWHITE
     );
     DrawText(
-        TextFormat("speed_step: %i", snaken->snake_speed_step),
+        TextFormat("speed_step: %i", frame->snake_speed_step),
         text_padding_x,
         text_padding_y + font_size * 2,
         font_size,
         RAYWHITE
     );
     DrawText(
-        TextFormat("stamina: %i", snaken->snake_stamina),
+        TextFormat("stamina: %i", frame->snake_stamina),
         text_padding_x,
         text_padding_y + font_size * 3,
         font_size,
         RAYWHITE
     );
     DrawText(
-        TextFormat("stamina_step: %i", snaken->snake_stamina_step),
+        TextFormat("stamina_step: %i", frame->snake_stamina_step),
         text_padding_x,
         text_padding_y + font_size * 4,
         font_size,
@@ -96,6 +292,260 @@ snaken_error_code_t draw_snaken(
     return SNAKEN_ERROR_NONE;
 }
 
+/// @brief Captures the provided world and draws it right away.
+/// @param renderer The renderer to draw with.
+/// @param snaken The world to draw.
+/// @param window_width The width of the window.
+/// @param window_height The height of the window.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t draw_snaken(
+    snaken_renderer_t* renderer,
+    snaken2d_t* snaken,
+    int window_width,
+    int window_height
+) {
+    snaken_error_code_t error;
+
+    if (renderer->frame.cells == NULL || renderer->frame.width != snaken->world_width || renderer->frame.height != snaken->world_height) {
+        snaken_frame_destroy(&(renderer->frame));
+        error = snaken_frame_init(&(renderer->frame), snaken->world_width, snaken->world_height);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    error = snaken_frame_capture(&(renderer->frame), snaken, &(renderer->palette));
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    return draw_snaken_frame(renderer, &(renderer->frame), window_width, window_height);
+}
+
+// Number of frames a world stays highlighted for after it was reset.
+#define SNAKEN_MOSAIC_RESET_FRAMES 30
+
+// Renders many worlds of the same size at once, as a grid of thumbnails.
+// All worlds share a single atlas texture, one tile per world, so the whole grid is drawn with a single scaled quad,
+// and only the cells changed in every tile since the last frame are uploaded.
+typedef struct {
+    // Size of every tile, the one of the drawn worlds.
+    snaken_world_size_t tile_width;
+    snaken_world_size_t tile_height;
+
+    // Grid the tiles are laid out in, fitting the largest thumbnails in the window.
+    int tiles_count;
+    int columns;
+    int rows;
+    int window_width;
+    int window_height;
+    float scale;
+
+    // Cells as currently held by the atlas.
+    uint8_t* uploaded;
+
+    // Last episode and remaining highlighted frames of every tile, so that resets stand out for a while.
+    uint64_t* episodes;
+    int* reset_frames;
+
+    Color dead_color;
+    Color reset_color;
+
+    Texture2D texture;
+} snaken_mosaic_t;
+
+/// @brief Initializes the provided mosaic.
+/// The atlas is only created when first drawing, so the window does not need to be open yet.
+/// @param mosaic The mosaic to initialize.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_mosaic_init(snaken_mosaic_t* mosaic) {
+    mosaic->tile_width = 0;
+    mosaic->tile_height = 0;
+    mosaic->tiles_count = 0;
+    mosaic->columns = 0;
+    mosaic->rows = 0;
+    mosaic->window_width = 0;
+    mosaic->window_height = 0;
+    mosaic->scale = 0.0f;
+    mosaic->uploaded = NULL;
+    mosaic->episodes = NULL;
+    mosaic->reset_frames = NULL;
+    mosaic->dead_color = (Color) {0xFF, 0x33, 0x33, 0xFF};
+    mosaic->reset_color = (Color) {0xFF, 0xDD, 0x33, 0xFF};
+    mosaic->texture = (Texture2D) {0};
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Releases the atlas and buffers of the provided mosaic. Must be called before closing the window.
+/// @param mosaic The mosaic to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_mosaic_destroy(snaken_mosaic_t* mosaic) {
+    if (mosaic->texture.id != 0) {
+        UnloadTexture(mosaic->texture);
+        mosaic->texture = (Texture2D) {0};
+    }
+    free(mosaic->uploaded);
+    free(mosaic->episodes);
+    free(mosaic->reset_frames);
+    mosaic->uploaded = NULL;
+    mosaic->episodes = NULL;
+    mosaic->reset_frames = NULL;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Lays the tiles of the provided mosaic out in the grid fitting the largest thumbnails in the window, then (re)creates its atlas.
+/// @param mosaic The mosaic to lay out.
+/// @param frames The frames to draw, their content being the initial one of the atlas.
+/// @param count The number of frames.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_mosaic_layout(
+    snaken_mosaic_t* mosaic,
+    snaken_frame_t** frames,
+    int count
+) {
+    snaken_mosaic_destroy(mosaic);
+
+    mosaic->tile_width = frames[0]->width;
+    mosaic->tile_height = frames[0]->height;
+    mosaic->tiles_count = count;
+    mosaic->scale = 0.0f;
+    for (int columns = 1; columns <= count; columns++) {
+        int rows = (count + columns - 1) / columns;
+        float scale_x = (float) mosaic->window_width / (columns * mosaic->tile_width);
+        float scale_y = (float) mosaic->window_height / (rows * mosaic->tile_height);
+        float scale = scale_x < scale_y ? scale_x : scale_y;
+        if (scale > mosaic->scale) {
+            mosaic->scale = scale;
+            mosaic->columns = columns;
+            mosaic->rows = rows;
+        }
+    }
+
+    // Keep cells evenly sized whenever thumbnails are at least a pixel per cell.
+    if (mosaic->scale >= 1.0f) mosaic->scale = (float) (int) mosaic->scale;
+
+    const int atlas_width = mosaic->columns * mosaic->tile_width;
+    const int atlas_height = mosaic->rows * mosaic->tile_height;
+    mosaic->uploaded = (uint8_t*) calloc((size_t) atlas_width * atlas_height, SNAKEN_RGB_CHANNELS);
+    mosaic->episodes = (uint64_t*) malloc(count * sizeof(uint64_t));
+    mosaic->reset_frames = (int*) calloc(count, sizeof(int));
+    if (mosaic->uploaded == NULL || mosaic->episodes == NULL || mosaic->reset_frames == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (int i = 0; i < count; i++) {
+        mosaic->episodes[i] = frames[i]->episode;
+    }
+
+    // Start out blank, so that the first frame uploads every tile as a whole.
+    Image image = {
+        .data = mosaic->uploaded,
+        .width = atlas_width,
+        .height = atlas_height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8
+    };
+    mosaic->texture = LoadTextureFromImage(image);
+    SetTextureFilter(mosaic->texture, TEXTURE_FILTER_POINT);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Draws the provided frames as a grid of thumbnails filling the window, highlighting dead and recently reset worlds.
+/// Frames are meant to be the latest snapshots published by the threads running the worlds, which never wait for the mosaic.
+/// @param mosaic The mosaic to draw with.
+/// @param frames The frames to draw, all of the same size.
+/// @param count The number of frames.
+/// @param window_width The width of the window.
+/// @param window_height The height of the window.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none,
+/// [SNAKEN_ERROR_INVALID_SIZE] if frames differ in size.
+snaken_error_code_t draw_snaken_mosaic(
+    snaken_mosaic_t* mosaic,
+    snaken_frame_t** frames,
+    int count,
+    int window_width,
+    int window_height
+) {
+    snaken_error_code_t error;
+
+    if (count <= 0) return SNAKEN_ERROR_NONE;
+    for (int i = 1; i < count; i++) {
+        if (frames[i]->width != frames[0]->width || frames[i]->height != frames[0]->height) {
+            return SNAKEN_ERROR_INVALID_SIZE;
+        }
+    }
+
+    // Lay tiles out again whenever the grid or the window changes, the first frame included.
+    if (mosaic->texture.id == 0 ||
+        mosaic->tiles_count != count ||
+        mosaic->tile_width != frames[0]->width ||
+        mosaic->tile_height != frames[0]->height ||
+        mosaic->window_width != window_width ||
+        mosaic->window_height != window_height) {
+        mosaic->window_width = window_width;
+        mosaic->window_height = window_height;
+        error = snaken_mosaic_layout(mosaic, frames, count);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    const size_t atlas_stride = (size_t) mosaic->columns * mosaic->tile_width * SNAKEN_RGB_CHANNELS;
+    for (int i = 0; i < count; i++) {
+        const int tile_x = (i % mosaic->columns) * mosaic->tile_width;
+        const int tile_y = (i / mosaic->columns) * mosaic->tile_height;
+
+        snaken_frame_upload(
+            mosaic->texture,
+            mosaic->uploaded + tile_y * atlas_stride + (size_t) tile_x * SNAKEN_RGB_CHANNELS,
+            atlas_stride,
+            tile_x,
+            tile_y,
+            frames[i]
+        );
+
+        if (frames[i]->episode != mosaic->episodes[i]) {
+            mosaic->episodes[i] = frames[i]->episode;
+            mosaic->reset_frames[i] = SNAKEN_MOSAIC_RESET_FRAMES;
+        }
+    }
+
+    // The whole grid is a single quad.
+    DrawTexturePro(
+        mosaic->texture,
+        (Rectangle) {0, 0, mosaic->columns * mosaic->tile_width, mosaic->rows * mosaic->tile_height},
+        (Rectangle) {0, 0, mosaic->columns * mosaic->tile_width * mosaic->scale, mosaic->rows * mosaic->tile_height * mosaic->scale},
+        (Vector2) {0, 0},
+        0.0f,
+        WHITE
+    );
+
+    // Only highlighted tiles take draw calls of their own.
+    const float tile_width = mosaic->tile_width * mosaic->scale;
+    const float tile_height = mosaic->tile_height * mosaic->scale;
+    for (int i = 0; i < count; i++) {
+        Rectangle tile = {
+            (i % mosaic->columns) * tile_width,
+            (i / mosaic->columns) * tile_height,
+            tile_width,
+            tile_height
+        };
+
+        if (!frames[i]->snake_alive) {
+            DrawRectangleRec(tile, Fade(BLACK, 0.5f));
+            DrawRectangleLinesEx(tile, 2.0f, mosaic->dead_color);
+        } else if (mosaic->reset_frames[i] > 0) {
+            DrawRectangleLinesEx(tile, 2.0f, Fade(mosaic->reset_color, (float) mosaic->reset_frames[i] / SNAKEN_MOSAIC_RESET_FRAMES));
+        }
+
+        if (mosaic->reset_frames[i] > 0) mosaic->reset_frames[i]--;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
 char cell_type_to_char(snaken_cell_type_t cell_type) {
     switch (cell_type) {
         case SNAKEN_SNAKE_HEAD:
@@ -1,6 +1,69 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <snaken/snaken.h>
 #include "draw_snaken.h"
+#include "triple_buffer.h"
+
+// Rate the world is ticked at, independently from the display rate, 0 for as fast as possible.
+#define TICKS_PER_SECOND 60
+
+// Simulation state shared between the simulation thread and the drawing one.
+typedef struct {
+    snaken2d_t* snaken;
+
+    // Frames of the world, published by the simulation at every tick and drawn at display rate.
+    triple_buffer_t frames;
+    snaken_palette_t* palette;
+
+    // Direction requested by the player and not applied yet, -1 if none.
+    _Atomic int direction;
+
+    _Atomic bool stopping;
+    _Atomic bool over;
+} game_t;
+
+/// @brief Ticks the world at [TICKS_PER_SECOND] until the snake dies or the game is stopped, publishing a frame after every tick.
+/// @param arg The game to run.
+void* game_loop(void* arg) {
+    game_t* game = (game_t*) arg;
+    struct timespec next_tick;
+    clock_gettime(CLOCK_MONOTONIC, &next_tick);
+
+    while (!atomic_load(&(game->stopping)) && game->snaken->snake_alive) {
+        int direction = atomic_exchange(&(game->direction), -1);
+        if (direction >= 0) {
+            snaken2d_set_snake_dir(game->snaken, (snaken_dir_t) direction);
+        }
+
+        // Tick the snaken.
+        snaken_error_code_t error = snaken2d_tick(game->snaken);
+        if (error != SNAKEN_ERROR_NONE) {
+            printf("There was an error ticking the snaken: %d\n", error);
+            break;
+        }
+
+        snaken_frame_capture(triple_buffer_back(&(game->frames)), game->snaken, game->palette);
+        triple_buffer_publish(&(game->frames));
+
+        // Wait for the next tick on an absolute schedule, so that ticking time does not add up.
+        if (TICKS_PER_SECOND > 0) {
+            next_tick.tv_nsec += 1000000000L / TICKS_PER_SECOND;
+            if (next_tick.tv_nsec >= 1000000000L) {
+                next_tick.tv_sec++;
+                next_tick.tv_nsec -= 1000000000L;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_tick, NULL);
+        }
+    }
+
+    atomic_store(&(game->over), true);
+
+    return NULL;
+}
 
 int main(void) {
     // Initialization
@@ -57,36 +120,66 @@ int main(void) {
     }
     snaken2d_set_walls(snaken, 10, walls);
 
+    snaken_renderer_t renderer;
+    snaken_renderer_init(&renderer);
+
+    // Every frame starts out as the initial world, so that the first one drawn is valid whatever the simulation got to.
+    snaken_frame_t frames[3];
+    for (int i = 0; i < 3; i++) {
+        error = snaken_frame_init(&(frames[i]), snaken->world_width, snaken->world_height);
+        if (error != SNAKEN_ERROR_NONE) {
+            printf("There was an error initializing frame %d: %d\n", i, error);
+            return 1;
+        }
+        snaken_frame_capture(&(frames[i]), snaken, &(renderer.palette));
+    }
+
+    game_t game = {
+        .snaken = snaken,
+        .palette = &(renderer.palette)
+    };
+    triple_buffer_init(&(game.frames), &(frames[0]), &(frames[1]), &(frames[2]));
+    atomic_init(&(game.direction), -1);
+    atomic_init(&(game.stopping), false);
+    atomic_init(&(game.over), false);
+
     InitWindow(
         screen_width,
         screen_height,
         "SNAKE"
     );
 
+    // Drawing only samples the latest frame, so the display rate no longer drives the simulation.
     SetTargetFPS(60);
+
+    pthread_t game_thread;
+    if (pthread_create(&game_thread, NULL, &game_loop, &game) != 0) {
+        printf("There was an error starting the game thread\n");
+        return 1;
+    }
     //---------------------------------------------------------------------------------
 
     // Main game loop
-    while (!WindowShouldClose() && snaken->snake_alive) {
+    while (!WindowShouldClose() && !atomic_load(&(game.over))) {
         // Update
         //----------------------------------------------------------------------------------
-        // Check for user input.
+        // Check for user input, applied by the game thread at its next tick.
         switch(GetKeyPressed()) {
             case KEY_UP:
             case KEY_W:
-                snaken2d_set_snake_dir(snaken, SNAKEN_UP);
+                atomic_store(&(game.direction), SNAKEN_UP);
                 break;
             case KEY_LEFT:
             case KEY_A:
-                snaken2d_set_snake_dir(snaken, SNAKEN_LEFT);
+                atomic_store(&(game.direction), SNAKEN_LEFT);
                 break;
             case KEY_DOWN:
             case KEY_S:
-                snaken2d_set_snake_dir(snaken, SNAKEN_DOWN);
+                atomic_store(&(game.direction), SNAKEN_DOWN);
                 break;
             case KEY_RIGHT:
             case KEY_D:
-                snaken2d_set_snake_dir(snaken, SNAKEN_RIGHT);
+                atomic_store(&(game.direction), SNAKEN_RIGHT);
                 break;
             default:
                 break;
@@ -97,27 +190,28 @@ int main(void) {
         //     return 1;
         // }
         // print_snake_view(view, snaken_view_width);
-
-        // Tick the snaken.
-        error = snaken2d_tick(snaken);
-        if (error != SNAKEN_ERROR_NONE) {
-            printf("ERROR\n");
-            return 1;
-        }
         //----------------------------------------------------------------------------------
 
         // Draw
         //----------------------------------------------------------------------------------
         BeginDrawing();
             ClearBackground(BLACK);
-            draw_snaken(snaken, screen_width, screen_height);
+            draw_snaken_frame(&renderer, triple_buffer_front(&(game.frames)), screen_width, screen_height);
         EndDrawing();
         //----------------------------------------------------------------------------------
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    atomic_store(&(game.stopping), true);
+    pthread_join(game_thread, NULL);
+
+    snaken_renderer_destroy(&renderer);
     CloseWindow();
+
+    for (int i = 0; i < 3; i++) {
+        snaken_frame_destroy(&(frames[i]));
+    }
     //--------------------------------------------------------------------------------------
 
     return 0;
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <signal.h>
+#include <getopt.h>
+#include <snaken/snaken.h>
+#include <snaken/shm.h>
+
+#define SHM_NAME "/snaken"
+#define WORLDS_COUNT 256
+#define WORLD_WIDTH 30
+#define WORLD_HEIGHT 30
+#define VIEW_RADIUS 3
+
+// Server being run, global so that signal handlers can stop it.
+static snaken_shm_server_t* server = NULL;
+
+void handle_signal(int signal) {
+   (void) signal;
+   if (server != NULL) snaken_shm_server_stop(server);
+}
+
+struct option serve_options[] = {
+   {"name", required_argument, 0, 'n'},
+   {"worlds_count", required_argument, 0, 'c'},
+   {"world_width", required_argument, 0, 'w'},
+   {"world_height", required_argument, 0, 'h'},
+   {"view_radius", required_argument, 0, 'r'},
+   {"depth", required_argument, 0, 'd'},
+   {"help", no_argument, 0, 'H'},
+   {0, no_argument, 0, 0}
+};
+
+int main(int argc, char** argv) {
+   char* name = SHM_NAME;
+   int worlds_count = WORLDS_COUNT;
+   int world_width = WORLD_WIDTH;
+   int world_height = WORLD_HEIGHT;
+   int view_radius = VIEW_RADIUS;
+   int depth = SNAKEN_DEFAULT_SHM_DEPTH;
+
+   // ##########################################
+   // Input handling.
+   // ##########################################
+   int opt;
+   int option_index = 0;
+
+   // Loop through all arguments
+   while ((opt = getopt_long(argc, argv, "", serve_options, &option_index)) != -1) {
+      switch (opt) {
+         case 'n':
+            name = optarg;
+            break;
+         case 'c':
+            worlds_count = atoi(optarg);
+            break;
+         case 'w':
+            world_width = atoi(optarg);
+            break;
+         case 'h':
+            world_height = atoi(optarg);
+            break;
+         case 'r':
+            view_radius = atoi(optarg);
+            break;
+         case 'd':
+            depth = atoi(optarg);
+            break;
+         case 'H':
+            printf("\n");
+            printf("snaken_server - hosts snaken worlds and steps them on behalf of clients connected through shared memory.\n");
+            printf("\tAvailable parameters:\n");
+            printf("\t\t--name [default %s] - sets the name of the shared memory segment.\n", SHM_NAME);
+            printf("\t\t--worlds_count [default %d] - sets the number of hosted worlds.\n", WORLDS_COUNT);
+            printf("\t\t--world_width [default %d] - sets the width of every world.\n", WORLD_WIDTH);
+            printf("\t\t--world_height [default %d] - sets the height of every world.\n", WORLD_HEIGHT);
+            printf("\t\t--view_radius [default %d] - sets the radius of the observed views.\n", VIEW_RADIUS);
+            printf("\t\t--depth [default %d] - sets how many steps clients can have in flight, plus one.\n", SNAKEN_DEFAULT_SHM_DEPTH);
+            printf("\n");
+            return 0;
+         case '?':
+            printf("Unknown option or missing value.\n");
+            return 1;
+         default:
+            abort();
+      }
+   }
+   // ##########################################
+   // ##########################################
+
+   snaken_error_code_t error = snaken_shm_server_init(
+      &server,
+      name,
+      worlds_count,
+      world_width,
+      world_height,
+      view_radius,
+      depth
+   );
+   if (error != SNAKEN_ERROR_NONE) {
+      printf("There was an error initializing the server: %d\n", error);
+      return 1;
+   }
+
+   signal(SIGINT, handle_signal);
+   signal(SIGTERM, handle_signal);
+
+   printf("Serving %d worlds (%dx%d) on %s\n", worlds_count, world_width, world_height, name);
+
+   error = snaken_shm_server_run(server);
+   if (error != SNAKEN_ERROR_NONE) {
+      printf("There was an error running the server: %d\n", error);
+   }
+
+   snaken_shm_server_destroy(server);
+
+   printf("Server stopped\n");
+
+   return error == SNAKEN_ERROR_NONE ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <stdatomic.h>
+
+// Flag set on the shared slot index while the slot it points to holds a snapshot the reader has not taken yet.
+#define TRIPLE_BUFFER_FRESH 0x04
+
+// Lock-free handoff of snapshots from a single writer to a single reader, neither of which ever waits for the other.
+// The writer always fills a slot of its own and the reader always reads a slot of its own, while the third slot holds the latest
+// published snapshot: publishing and taking snapshots only swap slots with it.
+typedef struct {
+    void* slots[3];
+
+    // Slot being filled, only ever touched by the writer.
+    int back;
+
+    // Slot being read, only ever touched by the reader.
+    int front;
+
+    // Slot holding the latest published snapshot, possibly flagged with [TRIPLE_BUFFER_FRESH].
+    _Atomic int middle;
+} triple_buffer_t;
+
+/// @brief Initializes the provided triple buffer over three snapshots, all of which must be readable right away.
+/// @param buffer The buffer to initialize.
+/// @param slot0 The first snapshot.
+/// @param slot1 The second snapshot.
+/// @param slot2 The third snapshot.
+void triple_buffer_init(triple_buffer_t* buffer, void* slot0, void* slot1, void* slot2) {
+    buffer->slots[0] = slot0;
+    buffer->slots[1] = slot1;
+    buffer->slots[2] = slot2;
+    buffer->back = 0;
+    atomic_init(&(buffer->middle), 1);
+    buffer->front = 2;
+}
+
+/// @brief Retrieves the snapshot the writer is to fill next.
+/// @param buffer The buffer to write to.
+/// @return The snapshot to fill.
+void* triple_buffer_back(triple_buffer_t* buffer) {
+    return buffer->slots[buffer->back];
+}
+
+/// @brief Publishes the snapshot filled by the writer, which then moves on to the previously published slot.
+/// @param buffer The buffer to publish to.
+void triple_buffer_publish(triple_buffer_t* buffer) {
+    buffer->back = atomic_exchange(&(buffer->middle), buffer->back | TRIPLE_BUFFER_FRESH) & ~TRIPLE_BUFFER_FRESH;
+}
+
+/// @brief Retrieves the latest published snapshot, which is left untouched by the writer until the next call.
+/// @param buffer The buffer to read from.
+/// @return The latest snapshot, the same as the previous call's if none was published since.
+void* triple_buffer_front(triple_buffer_t* buffer) {
+    if (atomic_load(&(buffer->middle)) & TRIPLE_BUFFER_FRESH) {
+        buffer->front = atomic_exchange(&(buffer->middle), buffer->front) & ~TRIPLE_BUFFER_FRESH;
+    }
+    return buffer->slots[buffer->front];
+}
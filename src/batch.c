@@ -0,0 +1,520 @@
+#include "batch.h"
+
+// ##########################################
+// Worker functions.
+// ##########################################
+
+/// @brief Derives the seed of an episode, so that every episode of every world is reproducible from the batch seed alone.
+/// @param batch The batch the world belongs to.
+/// @param id The stable identifier of the world.
+/// @param episode The number of the episode.
+/// @return The episode seed.
+static uint64_t snaken2d_batch_episode_seed(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t id,
+    uint64_t episode
+) {
+    snaken_rng_t rng = batch->seed ^ ((uint64_t) id * 0xD1B54A32D192ED03u) ^ (episode * 0x8CB92BA72F3D8DD7u);
+    return snaken_rng_next(&rng);
+}
+
+/// @brief Starts the next episode of the world in the provided row.
+/// @param batch The batch the world belongs to.
+/// @param row The row of the world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_batch_reset_row(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t row
+) {
+    batch->episodes[row]++;
+    batch->episode_steps[row] = 0;
+    batch->eaten_apples[row] = 0;
+
+    return snaken2d_reset(batch->worlds[row], snaken2d_batch_episode_seed(batch, batch->ids[row], batch->episodes[row]));
+}
+
+/// @brief Tells whether the episode of the world in the provided row is over, either because its snake died or because it was truncated.
+/// @param batch The batch the world belongs to.
+/// @param row The row of the world.
+/// @return Whether the episode is over.
+static snaken_bool_t snaken2d_batch_row_over(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t row
+) {
+    return !batch->worlds[row]->snake_alive ||
+        (batch->max_episode_steps > 0 && batch->episode_steps[row] >= batch->max_episode_steps);
+}
+
+/// @brief Steps the world in the provided row and writes its results, resetting it if so specified and its episode ended.
+/// @param worker The worker performing the step.
+/// @param row The row of the world to step.
+static void snaken2d_batch_step_world(
+    snaken2d_batch_worker_t* worker,
+    snaken_world_size_t row
+) {
+    snaken2d_batch_t* batch = worker->batch;
+    snaken2d_t* world = batch->worlds[row];
+    snaken_obs_t* view = batch->views + (size_t) row * batch->layout.view_stride;
+    snaken_obs_t* feature = batch->features + (size_t) row * batch->layout.features_stride;
+
+    // Worlds whose episode is over stay as they are until reset, a starved one has no body left to tick anyway.
+    snaken_bool_t was_live = !snaken2d_batch_row_over(batch, row);
+    if (was_live) {
+        snaken2d_apply_action(world, batch->actions[row]);
+        snaken2d_tick(world);
+        batch->episode_steps[row]++;
+    }
+
+    batch->rewards[row] = (float) (world->eaten_apples_count - batch->eaten_apples[row]);
+    batch->eaten_apples[row] = world->eaten_apples_count;
+    batch->dones[row] = !world->snake_alive;
+    batch->truncateds[row] = world->snake_alive && batch->max_episode_steps > 0 && batch->episode_steps[row] >= batch->max_episode_steps;
+    if (was_live && !world->snake_alive) batch->rewards[row] -= 1.0f;
+
+    if (batch->auto_reset && (batch->dones[row] || batch->truncateds[row])) {
+        // Keep the final observation apart, then start over in the same step.
+        snaken2d_get_obs(
+            world,
+            &(batch->layout),
+            worker->scratch,
+            batch->terminal_views + (size_t) row * batch->layout.view_stride,
+            batch->terminal_features + (size_t) row * batch->layout.features_stride
+        );
+        snaken2d_batch_reset_row(batch, row);
+    }
+
+    snaken2d_get_obs(world, &(batch->layout), worker->scratch, view, feature);
+}
+
+/// @brief Swaps two rows of the provided batch, along with all their data.
+/// @param batch The batch to swap rows of.
+/// @param a The first row.
+/// @param b The second row.
+static void snaken2d_batch_swap_rows(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t a,
+    snaken_world_size_t b
+) {
+    #define SWAP_ROW(array, type) { type tmp = batch->array[a]; batch->array[a] = batch->array[b]; batch->array[b] = tmp; }
+    SWAP_ROW(worlds, snaken2d_t*);
+    SWAP_ROW(ids, snaken_world_size_t);
+    SWAP_ROW(episodes, uint64_t);
+    SWAP_ROW(episode_steps, snaken_world_size_t);
+    SWAP_ROW(eaten_apples, snaken_world_size_t);
+    SWAP_ROW(actions, uint8_t);
+    SWAP_ROW(rewards, float);
+    SWAP_ROW(dones, uint8_t);
+    SWAP_ROW(truncateds, uint8_t);
+    #undef SWAP_ROW
+
+    for (snaken_world_size_t i = 0; i < batch->layout.view_stride; i++) {
+        snaken_obs_t tmp = batch->views[(size_t) a * batch->layout.view_stride + i];
+        batch->views[(size_t) a * batch->layout.view_stride + i] = batch->views[(size_t) b * batch->layout.view_stride + i];
+        batch->views[(size_t) b * batch->layout.view_stride + i] = tmp;
+    }
+    for (snaken_world_size_t i = 0; i < batch->layout.features_stride; i++) {
+        snaken_obs_t tmp = batch->features[(size_t) a * batch->layout.features_stride + i];
+        batch->features[(size_t) a * batch->layout.features_stride + i] = batch->features[(size_t) b * batch->layout.features_stride + i];
+        batch->features[(size_t) b * batch->layout.features_stride + i] = tmp;
+    }
+}
+
+/// @brief Runs a worker: repeatedly picks a pending world, steps it and marks it as ready, until the batch stops.
+/// @param arg The worker context, see [snaken2d_batch_worker_t].
+/// @return NULL.
+static void* snaken2d_batch_work(void* arg) {
+    snaken2d_batch_worker_t* worker = (snaken2d_batch_worker_t*) arg;
+    snaken2d_batch_t* batch = worker->batch;
+
+    pthread_mutex_lock(&(batch->lock));
+    for (;;) {
+        while (batch->pending_length == 0 && !batch->stopping) {
+            pthread_cond_wait(&(batch->work_available), &(batch->lock));
+        }
+        if (batch->pending_length == 0) break;
+
+        // Pick the oldest pending row.
+        snaken_world_size_t row = batch->pending[batch->pending_head];
+        batch->pending_head = (batch->pending_head + 1) % batch->worlds_count;
+        batch->pending_length--;
+
+        // Worlds are independent, so the step runs unlocked.
+        pthread_mutex_unlock(&(batch->lock));
+        snaken2d_batch_step_world(worker, row);
+        pthread_mutex_lock(&(batch->lock));
+
+        batch->ready[(batch->ready_head + batch->ready_length) % batch->worlds_count] = row;
+        batch->ready_length++;
+        batch->in_flight--;
+        batch->states[row] = SNAKEN_BATCH_READY;
+        pthread_cond_signal(&(batch->work_done));
+    }
+    pthread_mutex_unlock(&(batch->lock));
+
+    return NULL;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+/// @brief Stops and joins the provided number of started workers, then frees the provided batch along with everything it holds.
+/// Parts not allocated yet must be NULL, so that a partially initialized batch can be freed as well.
+/// @param batch The batch to free.
+/// @param threads_started The number of worker threads started so far.
+static void snaken2d_batch_free(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t threads_started
+) {
+    // Let workers drain pending steps and exit.
+    pthread_mutex_lock(&(batch->lock));
+    batch->stopping = SNAKEN_TRUE;
+    pthread_cond_broadcast(&(batch->work_available));
+    pthread_mutex_unlock(&(batch->lock));
+
+    for (snaken_world_size_t t = 0; t < threads_started; t++) {
+        pthread_join(batch->threads[t], NULL);
+    }
+    if (batch->workers != NULL) {
+        for (snaken_world_size_t t = 0; t < batch->threads_count; t++) {
+            free(batch->workers[t].scratch);
+        }
+    }
+    free(batch->threads);
+    free(batch->workers);
+
+    pthread_mutex_destroy(&(batch->lock));
+    pthread_cond_destroy(&(batch->work_available));
+    pthread_cond_destroy(&(batch->work_done));
+
+    if (batch->worlds != NULL) {
+        for (snaken_world_size_t n = 0; n < batch->worlds_count; n++) {
+            if (batch->worlds[n] != NULL) snaken2d_destroy(batch->worlds[n]);
+        }
+    }
+    free(batch->worlds);
+    free(batch->states);
+    free(batch->actions);
+    free(batch->eaten_apples);
+    free(batch->rewards);
+    free(batch->dones);
+    free(batch->truncateds);
+    free(batch->ids);
+    free(batch->episodes);
+    free(batch->episode_steps);
+    free(batch->pending);
+    free(batch->ready);
+    free(batch->step_rows);
+    free(batch->step_received);
+    free(batch->views);
+    free(batch->features);
+    free(batch->terminal_views);
+    free(batch->terminal_features);
+    free(batch);
+}
+
+snaken_error_code_t snaken2d_batch_init(
+    snaken2d_batch_t** batch,
+    snaken_world_size_t worlds_count,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t view_radius,
+    snaken_world_size_t threads_count,
+    uint64_t seed
+) {
+    snaken_error_code_t error;
+
+    if (worlds_count <= 0 || threads_count <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Allocate the batch, zeroed so that it can be freed at any point of its initialization.
+    (*batch) = (snaken2d_batch_t*) calloc(1, sizeof(snaken2d_batch_t));
+    if ((*batch) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    pthread_mutex_init(&((*batch)->lock), NULL);
+    pthread_cond_init(&((*batch)->work_available), NULL);
+    pthread_cond_init(&((*batch)->work_done), NULL);
+
+    // Allocate worlds and results.
+    (*batch)->worlds_count = worlds_count;
+    (*batch)->worlds = (snaken2d_t**) calloc(worlds_count, sizeof(snaken2d_t*));
+    (*batch)->states = (uint8_t*) calloc(worlds_count, sizeof(uint8_t));
+    (*batch)->actions = (uint8_t*) calloc(worlds_count, sizeof(uint8_t));
+    (*batch)->eaten_apples = (snaken_world_size_t*) calloc(worlds_count, sizeof(snaken_world_size_t));
+    (*batch)->rewards = (float*) calloc(worlds_count, sizeof(float));
+    (*batch)->dones = (uint8_t*) calloc(worlds_count, sizeof(uint8_t));
+    (*batch)->truncateds = (uint8_t*) calloc(worlds_count, sizeof(uint8_t));
+    (*batch)->ids = (snaken_world_size_t*) malloc(worlds_count * sizeof(snaken_world_size_t));
+    (*batch)->episodes = (uint64_t*) calloc(worlds_count, sizeof(uint64_t));
+    (*batch)->episode_steps = (snaken_world_size_t*) calloc(worlds_count, sizeof(snaken_world_size_t));
+    (*batch)->pending = (snaken_world_size_t*) malloc(worlds_count * sizeof(snaken_world_size_t));
+    (*batch)->ready = (snaken_world_size_t*) malloc(worlds_count * sizeof(snaken_world_size_t));
+    (*batch)->step_rows = (snaken_world_size_t*) malloc(worlds_count * sizeof(snaken_world_size_t));
+    (*batch)->step_received = (snaken_world_size_t*) malloc(worlds_count * sizeof(snaken_world_size_t));
+    if ((*batch)->worlds == NULL || (*batch)->states == NULL || (*batch)->actions == NULL || (*batch)->eaten_apples == NULL ||
+        (*batch)->rewards == NULL || (*batch)->dones == NULL || (*batch)->truncateds == NULL || (*batch)->ids == NULL ||
+        (*batch)->episodes == NULL || (*batch)->episode_steps == NULL || (*batch)->pending == NULL || (*batch)->ready == NULL ||
+        (*batch)->step_rows == NULL || (*batch)->step_received == NULL) {
+        snaken2d_batch_free(*batch, 0);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_world_size_t n = 0; n < worlds_count; n++) {
+        (*batch)->ids[n] = n;
+        (*batch)->step_rows[n] = n;
+    }
+    (*batch)->live_count = worlds_count;
+
+    // Episodes end for good by default.
+    (*batch)->seed = seed;
+    (*batch)->auto_reset = SNAKEN_FALSE;
+    (*batch)->compaction = SNAKEN_FALSE;
+    (*batch)->max_episode_steps = 0;
+
+    error = snaken_obs_layout_init(&((*batch)->layout), view_radius);
+    if (error != SNAKEN_ERROR_NONE) {
+        snaken2d_batch_free(*batch, 0);
+        return error;
+    }
+    error = snaken_obs_batch_alloc(&((*batch)->layout), worlds_count, &((*batch)->views), &((*batch)->features));
+    if (error != SNAKEN_ERROR_NONE) {
+        snaken2d_batch_free(*batch, 0);
+        return error;
+    }
+    error = snaken_obs_batch_alloc(&((*batch)->layout), worlds_count, &((*batch)->terminal_views), &((*batch)->terminal_features));
+    if (error != SNAKEN_ERROR_NONE) {
+        snaken2d_batch_free(*batch, 0);
+        return error;
+    }
+
+    // Start every world from its first seeded episode.
+    for (snaken_world_size_t n = 0; n < worlds_count; n++) {
+        error = snaken2d_init(&((*batch)->worlds[n]), world_width, world_height);
+        if (error != SNAKEN_ERROR_NONE) {
+            // A world failing its initialization is left half initialized, so it cannot be destroyed.
+            (*batch)->worlds[n] = NULL;
+            snaken2d_batch_free(*batch, 0);
+            return error;
+        }
+        error = snaken2d_reset((*batch)->worlds[n], snaken2d_batch_episode_seed(*batch, n, 0));
+        if (error != SNAKEN_ERROR_NONE) {
+            snaken2d_batch_free(*batch, 0);
+            return error;
+        }
+    }
+
+    // Publish initial observations.
+    error = snaken2d_get_obs_batch((*batch)->worlds, worlds_count, &((*batch)->layout), (*batch)->views, (*batch)->features);
+    if (error != SNAKEN_ERROR_NONE) {
+        snaken2d_batch_free(*batch, 0);
+        return error;
+    }
+
+    // Setup scheduling.
+    (*batch)->pending_head = 0;
+    (*batch)->pending_length = 0;
+    (*batch)->ready_head = 0;
+    (*batch)->ready_length = 0;
+    (*batch)->in_flight = 0;
+    (*batch)->stopping = SNAKEN_FALSE;
+
+    // Start workers, each with its own scratch space.
+    (*batch)->threads_count = threads_count;
+    (*batch)->threads = (pthread_t*) malloc(threads_count * sizeof(pthread_t));
+    (*batch)->workers = (snaken2d_batch_worker_t*) calloc(threads_count, sizeof(snaken2d_batch_worker_t));
+    if ((*batch)->threads == NULL || (*batch)->workers == NULL) {
+        snaken2d_batch_free(*batch, 0);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_world_size_t t = 0; t < threads_count; t++) {
+        (*batch)->workers[t].batch = *batch;
+        (*batch)->workers[t].scratch = (snaken_cell_type_t*) malloc(
+            (*batch)->layout.view_diameter * (*batch)->layout.view_diameter * sizeof(snaken_cell_type_t)
+        );
+        if ((*batch)->workers[t].scratch == NULL) {
+            snaken2d_batch_free(*batch, t);
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+        if (pthread_create(&((*batch)->threads[t]), NULL, snaken2d_batch_work, &((*batch)->workers[t])) != 0) {
+            snaken2d_batch_free(*batch, t);
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_destroy(snaken2d_batch_t* batch) {
+    snaken2d_batch_free(batch, batch->threads_count);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_batch_send(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t count,
+    snaken_world_size_t* rows,
+    uint8_t* actions
+) {
+    pthread_mutex_lock(&(batch->lock));
+
+    // Make sure all rows can be stepped before sending anything.
+    for (snaken_world_size_t i = 0; i < count; i++) {
+        if (rows[i] < 0 || rows[i] >= batch->worlds_count || batch->states[rows[i]] != SNAKEN_BATCH_IDLE) {
+            // Roll back the rows marked so far.
+            for (snaken_world_size_t j = 0; j < i; j++) {
+                batch->states[rows[j]] = SNAKEN_BATCH_IDLE;
+            }
+            pthread_mutex_unlock(&(batch->lock));
+            return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+        }
+        // Mark the row right away, so that duplicate rows are caught as well.
+        batch->states[rows[i]] = SNAKEN_BATCH_PENDING;
+    }
+
+    for (snaken_world_size_t i = 0; i < count; i++) {
+        batch->actions[rows[i]] = actions[i];
+        batch->pending[(batch->pending_head + batch->pending_length) % batch->worlds_count] = rows[i];
+        batch->pending_length++;
+    }
+    batch->in_flight += count;
+
+    pthread_cond_broadcast(&(batch->work_available));
+    pthread_mutex_unlock(&(batch->lock));
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_recv(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t min_count,
+    snaken_world_size_t max_count,
+    snaken_world_size_t* rows,
+    snaken_world_size_t* count
+) {
+    pthread_mutex_lock(&(batch->lock));
+
+    // Wait for enough worlds, or for all outstanding ones if fewer.
+    while (batch->ready_length < min_count && batch->in_flight > 0) {
+        pthread_cond_wait(&(batch->work_done), &(batch->lock));
+    }
+
+    (*count) = batch->ready_length < max_count ? batch->ready_length : max_count;
+    for (snaken_world_size_t i = 0; i < (*count); i++) {
+        rows[i] = batch->ready[batch->ready_head];
+        batch->ready_head = (batch->ready_head + 1) % batch->worlds_count;
+        batch->states[rows[i]] = SNAKEN_BATCH_IDLE;
+    }
+    batch->ready_length -= (*count);
+
+    pthread_mutex_unlock(&(batch->lock));
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_step(
+    snaken2d_batch_t* batch,
+    uint8_t* actions
+) {
+    snaken_error_code_t error;
+    snaken_world_size_t received;
+
+    // Rows are about to move, so no asynchronous step can be outstanding.
+    pthread_mutex_lock(&(batch->lock));
+    snaken_bool_t outstanding = batch->in_flight > 0 || batch->ready_length > 0;
+    pthread_mutex_unlock(&(batch->lock));
+    if (outstanding) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Only step live rows if they are packed at the front.
+    snaken_world_size_t rows_count = batch->compaction && !batch->auto_reset ? batch->live_count : batch->worlds_count;
+
+    error = snaken2d_batch_send(batch, rows_count, batch->step_rows, actions);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+    error = snaken2d_batch_recv(batch, rows_count, rows_count, batch->step_received, &received);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    if (!batch->compaction || batch->auto_reset) return SNAKEN_ERROR_NONE;
+
+    // Move worlds whose episode is over behind the live ones by swapping them with the last live row.
+    snaken_world_size_t row = 0;
+    while (row < batch->live_count) {
+        if (!snaken2d_batch_row_over(batch, row)) {
+            row++;
+        } else {
+            batch->live_count--;
+            snaken2d_batch_swap_rows(batch, row, batch->live_count);
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_reset(snaken2d_batch_t* batch) {
+    pthread_mutex_lock(&(batch->lock));
+    snaken_bool_t outstanding = batch->in_flight > 0 || batch->ready_length > 0;
+    pthread_mutex_unlock(&(batch->lock));
+    if (outstanding) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    for (snaken_world_size_t row = 0; row < batch->worlds_count; row++) {
+        snaken_error_code_t error = snaken2d_batch_reset_row(batch, row);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+        batch->rewards[row] = 0.0f;
+        batch->dones[row] = SNAKEN_FALSE;
+        batch->truncateds[row] = SNAKEN_FALSE;
+    }
+    batch->live_count = batch->worlds_count;
+
+    return snaken2d_get_obs_batch(batch->worlds, batch->worlds_count, &(batch->layout), batch->views, batch->features);
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_batch_set_auto_reset(snaken2d_batch_t* batch, snaken_bool_t val) {
+    batch->auto_reset = val;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_set_compaction(snaken2d_batch_t* batch, snaken_bool_t val) {
+    batch->compaction = val;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_batch_set_max_episode_steps(snaken2d_batch_t* batch, snaken_world_size_t max_episode_steps) {
+    batch->max_episode_steps = max_episode_steps;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -0,0 +1,295 @@
+/*
+*****************************************************************
+batch.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __SNAKEN_BATCH__
+#define __SNAKEN_BATCH__
+
+#include <pthread.h>
+
+#include "snaken.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lifecycle of every world in a batch.
+typedef enum {
+    // Results were received (or the world was never stepped), so a new step can be sent.
+    SNAKEN_BATCH_IDLE = 0x00,
+    // A step was sent and is queued or running.
+    SNAKEN_BATCH_PENDING = 0x01,
+    // The step completed and its results are waiting to be received.
+    SNAKEN_BATCH_READY = 0x02
+} snaken_batch_state_t;
+
+typedef struct snaken2d_batch_t snaken2d_batch_t;
+
+// Per-thread context of a batch worker.
+typedef struct {
+    // The batch the worker belongs to.
+    snaken2d_batch_t* batch;
+
+    // Scratch cell view used for observations.
+    snaken_cell_type_t* scratch;
+} snaken2d_batch_worker_t;
+
+// A set of worlds stepped by a pool of worker threads.
+// Steps are sent for any subset of worlds and their results are received as soon as they complete, in completion order,
+// so that a consumer never waits on the slowest world.
+struct snaken2d_batch_t {
+    // ################
+    // Worlds.
+    // ################
+
+    // Number of worlds.
+    snaken_world_size_t worlds_count;
+
+    // Worlds array.
+    snaken2d_t** worlds;
+
+    // State of the world in every row, see [snaken_batch_state_t].
+    uint8_t* states;
+
+    // Action of the step sent to every world.
+    uint8_t* actions;
+
+    // Eaten apples count of every world after its last step, used to compute rewards.
+    snaken_world_size_t* eaten_apples;
+
+    // Stable identifier of the world in every row. Rows only move when live worlds are compacted.
+    snaken_world_size_t* ids;
+
+    // Number of the current episode of every world.
+    uint64_t* episodes;
+
+    // Number of steps in the current episode of every world.
+    snaken_world_size_t* episode_steps;
+
+    // Number of rows holding live worlds, whose episode is neither over nor truncated, packed at the front if compaction is enabled.
+    snaken_world_size_t live_count;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Episode management.
+    // ################
+
+    // Seed every episode seed is derived from, together with world identifier and episode number.
+    uint64_t seed;
+
+    // Whether worlds are reset in place as soon as their episode ends.
+    snaken_bool_t auto_reset;
+
+    // Whether synchronous steps move worlds whose episode is over behind live ones. Only effective without auto reset.
+    snaken_bool_t compaction;
+
+    // Number of steps after which episodes are truncated, 0 for unlimited.
+    // Without auto reset, truncated worlds are not stepped anymore until reset, just like dead ones.
+    snaken_world_size_t max_episode_steps;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Results, indexed by row.
+    // ################
+
+    // Layout of observations.
+    snaken_obs_layout_t layout;
+
+    // Observed views and features, one row per world.
+    snaken_obs_t* views;
+    snaken_obs_t* features;
+
+    // Reward of the last step of every world: eaten apples, minus 1 on death.
+    float* rewards;
+
+    // Whether every snake is dead after its last step. With auto reset, whether it died during its last step.
+    uint8_t* dones;
+
+    // Whether the episode of every world hit [max_episode_steps] during its last step, with the snake still alive.
+    uint8_t* truncateds;
+
+    // Final observation of every world whose episode ended during its last step, only written with auto reset.
+    // The regular observation then holds the first observation of the new episode.
+    snaken_obs_t* terminal_views;
+    snaken_obs_t* terminal_features;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Scheduling.
+    // ################
+
+    // Circular queue of the rows whose step was sent but not picked up by a worker yet.
+    snaken_world_size_t* pending;
+    snaken_world_size_t pending_head;
+    snaken_world_size_t pending_length;
+
+    // Circular queue of the rows whose step completed, in completion order.
+    snaken_world_size_t* ready;
+    snaken_world_size_t ready_head;
+    snaken_world_size_t ready_length;
+
+    // Number of worlds sent but not completed yet, queued or running.
+    snaken_world_size_t in_flight;
+
+    // Guards all scheduling fields and world states.
+    pthread_mutex_t lock;
+
+    // Signalled when pending worlds are queued or the batch is stopping.
+    pthread_cond_t work_available;
+
+    // Signalled when a world completes.
+    pthread_cond_t work_done;
+
+    // Whether workers should exit.
+    snaken_bool_t stopping;
+
+    // Scratch rows and indexes used by synchronous steps.
+    snaken_world_size_t* step_rows;
+    snaken_world_size_t* step_received;
+
+    // Worker threads.
+    snaken_world_size_t threads_count;
+    pthread_t* threads;
+    snaken2d_batch_worker_t* workers;
+
+    // ################
+    // ################
+};
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+/// @brief Initializes a batch of [worlds_count] default worlds and starts its workers.
+/// @param batch The batch to initialize.
+/// @param worlds_count The number of worlds.
+/// @param world_width The width of every world.
+/// @param world_height The height of every world.
+/// @param view_radius The radius of the observed views.
+/// @param threads_count The number of worker threads.
+/// @param seed The seed all episodes are derived from, making the whole batch reproducible.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_init(
+    snaken2d_batch_t** batch,
+    snaken_world_size_t worlds_count,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t view_radius,
+    snaken_world_size_t threads_count,
+    uint64_t seed
+);
+
+/// @brief Stops the workers, waiting for running steps to complete, and destroys the batch and its worlds.
+/// @param batch The batch to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_destroy(snaken2d_batch_t* batch);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+/// @brief Sends one step to each of the worlds in the provided rows, without waiting for any to complete.
+/// Rows are positions in the batch arrays: the world in row [r] is [batch->ids[r]], which only differs from [r] once
+/// synchronous steps compacted live worlds.
+/// @param batch The batch the worlds belong to.
+/// @param count The number of worlds to step.
+/// @param rows The rows of the worlds to step.
+/// @param actions The action of every stepped world, see [snaken_action_t].
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any row does not exist or is not idle, in which case nothing is sent.
+snaken_error_code_t snaken2d_batch_send(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t count,
+    snaken_world_size_t* rows,
+    uint8_t* actions
+);
+
+/// @brief Waits for [min_count] worlds to complete their step and receives them, in completion order.
+/// Waits for less if fewer steps are outstanding, and returns immediately with no worlds if none are.
+/// Results of every received world can be read from the batch results at its row until its next step is sent.
+/// @param batch The batch to receive from.
+/// @param min_count The number of worlds to wait for.
+/// @param max_count The maximum number of worlds to receive, at least [min_count].
+/// @param rows The rows of the received worlds, holding at least [max_count] elements. Map them to worlds through [batch->ids].
+/// @param count The number of received worlds.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_recv(
+    snaken2d_batch_t* batch,
+    snaken_world_size_t min_count,
+    snaken_world_size_t max_count,
+    snaken_world_size_t* rows,
+    snaken_world_size_t* count
+);
+
+/// @brief Steps all live worlds once and waits for all of them, using the worker pool.
+/// With compaction enabled and auto reset disabled, worlds whose episode ended, by death or truncation, are then moved behind
+/// the live ones: rows [0, live_count) hold live worlds, rows [live_count, previous live_count) hold the worlds whose episode
+/// ended during this step.
+/// Use [ids] to map rows back to worlds.
+/// @param batch The batch to step.
+/// @param actions The action of every live row, see [snaken_action_t].
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any asynchronous step is outstanding.
+snaken_error_code_t snaken2d_batch_step(
+    snaken2d_batch_t* batch,
+    uint8_t* actions
+);
+
+/// @brief Starts a new episode in every world, making all of them live again.
+/// @param batch The batch to reset.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any asynchronous step is outstanding.
+snaken_error_code_t snaken2d_batch_reset(snaken2d_batch_t* batch);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+/// @brief Sets whether worlds are reset in place as soon as their episode ends, during the same step.
+/// @param batch The batch to update.
+/// @param val Whether to reset worlds automatically.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_set_auto_reset(snaken2d_batch_t* batch, snaken_bool_t val);
+
+/// @brief Sets whether synchronous steps pack live worlds at the front, so that no work is spent on dead or truncated ones.
+/// @param batch The batch to update.
+/// @param val Whether to compact live worlds.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_set_compaction(snaken2d_batch_t* batch, snaken_bool_t val);
+
+/// @brief Sets the number of steps after which episodes are truncated.
+/// @param batch The batch to update.
+/// @param max_episode_steps The maximum number of steps per episode, 0 for unlimited.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_batch_set_max_episode_steps(snaken2d_batch_t* batch, snaken_world_size_t max_episode_steps);
+
+// ##########################################
+// ##########################################
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,7 +5,10 @@ typedef enum {
     SNAKEN_ERROR_NONE = 0x00,
     SNAKEN_ERROR_FAILED_ALLOC = 0x01,
     SNAKEN_ERROR_INDEX_OUT_OF_RANGE = 0x02,
-    SNAKEN_ERROR_INVALID_DIRECTION = 0x03
+    SNAKEN_ERROR_INVALID_DIRECTION = 0x03,
+    SNAKEN_ERROR_FEATURE_DISABLED = 0x04,
+    SNAKEN_ERROR_FAILED_SHM = 0x05,
+    SNAKEN_ERROR_INVALID_SIZE = 0x06
 } snaken_error_code_t;
 
 #endif
@@ -0,0 +1,683 @@
+#include "large.h"
+
+// ##########################################
+// Tile directory functions.
+// ##########################################
+
+/// @brief Hashes the provided tile key into a directory slot.
+/// @param key The tile key to hash.
+/// @param capacity The directory capacity, a power of 2.
+/// @return The slot to start probing from.
+static snaken_cell_index_t snaken_tile_hash(
+    snaken_cell_index_t key,
+    snaken_cell_index_t capacity
+) {
+    // Fibonacci hashing spreads neighboring tiles across the directory.
+    uint64_t hash = ((uint64_t) key) * 0x9E3779B97F4A7C15u;
+    return (snaken_cell_index_t) ((hash ^ (hash >> 32)) & (uint64_t) (capacity - 1));
+}
+
+/// @brief Inserts the provided tile into the provided directory, which is assumed not to hold it yet nor to be full.
+/// @param tiles The directory to insert into.
+/// @param capacity The directory capacity.
+/// @param key The key of the tile.
+/// @param tile The tile to insert.
+static void snaken_tile_insert(
+    snaken_tile_slot_t* tiles,
+    snaken_cell_index_t capacity,
+    snaken_cell_index_t key,
+    snaken_tile_t* tile
+) {
+    snaken_cell_index_t slot = snaken_tile_hash(key, capacity);
+    while (tiles[slot].key >= 0) slot = (slot + 1) & (capacity - 1);
+
+    tiles[slot].key = key;
+    tiles[slot].tile = tile;
+}
+
+/// @brief Doubles the directory capacity, rehashing all tiles. Tiles themselves never move.
+/// @param snaken The snaken to grow the directory of.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_large_grow_tiles(
+    snaken2d_large_t* snaken
+) {
+    snaken_cell_index_t new_capacity = snaken->tiles_capacity * 2;
+    snaken_tile_slot_t* new_tiles = (snaken_tile_slot_t*) malloc(new_capacity * sizeof(snaken_tile_slot_t));
+    if (new_tiles == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_cell_index_t i = 0; i < new_capacity; i++) {
+        new_tiles[i].key = -1;
+        new_tiles[i].tile = NULL;
+    }
+
+    for (snaken_cell_index_t i = 0; i < snaken->tiles_capacity; i++) {
+        if (snaken->tiles[i].key >= 0) snaken_tile_insert(new_tiles, new_capacity, snaken->tiles[i].key, snaken->tiles[i].tile);
+    }
+
+    free(snaken->tiles);
+    snaken->tiles = new_tiles;
+    snaken->tiles_capacity = new_capacity;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Looks up the tile holding the provided location.
+/// @param snaken The snaken to look the tile up in.
+/// @param location The location to look up.
+/// @param allocate Whether to allocate the tile if missing.
+/// @param local The index of the location within the tile.
+/// @return The tile holding the location, NULL if missing and not allocated.
+static snaken_tile_t* snaken2d_large_tile(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location,
+    snaken_bool_t allocate,
+    snaken_cell_index_t* local
+) {
+    snaken_cell_index_t x = location % snaken->world_width;
+    snaken_cell_index_t y = location / snaken->world_width;
+    snaken_cell_index_t tiles_per_row = (snaken->world_width + SNAKEN_TILE_SIZE - 1) / SNAKEN_TILE_SIZE;
+    snaken_cell_index_t key = IDX2D(x / SNAKEN_TILE_SIZE, y / SNAKEN_TILE_SIZE, tiles_per_row);
+
+    (*local) = IDX2D(x % SNAKEN_TILE_SIZE, y % SNAKEN_TILE_SIZE, SNAKEN_TILE_SIZE);
+
+    // Most lookups hit the same tile as the previous one.
+    if (snaken->last_tile.key == key) return snaken->last_tile.tile;
+
+    snaken_cell_index_t slot = snaken_tile_hash(key, snaken->tiles_capacity);
+    while (snaken->tiles[slot].key >= 0) {
+        if (snaken->tiles[slot].key == key) {
+            snaken->last_tile = snaken->tiles[slot];
+            return snaken->tiles[slot].tile;
+        }
+        slot = (slot + 1) & (snaken->tiles_capacity - 1);
+    }
+
+    if (!allocate) return NULL;
+
+    // Keep the directory at most half full, so that probe sequences stay short.
+    if ((snaken->tiles_count + 1) * 2 > snaken->tiles_capacity) {
+        if (snaken2d_large_grow_tiles(snaken) != SNAKEN_ERROR_NONE) return NULL;
+    }
+
+    snaken_tile_t* tile = (snaken_tile_t*) calloc(1, sizeof(snaken_tile_t));
+    if (tile == NULL) return NULL;
+
+    snaken_tile_insert(snaken->tiles, snaken->tiles_capacity, key, tile);
+    snaken->tiles_count++;
+    snaken->last_tile.key = key;
+    snaken->last_tile.tile = tile;
+
+    return tile;
+}
+
+/// @brief Retrieves the flags of the provided location, treating missing tiles as empty.
+/// @param snaken The snaken to read the flags from.
+/// @param location The location to read.
+/// @return The location flags.
+static uint8_t snaken2d_large_flags(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location
+) {
+    snaken_cell_index_t local;
+    snaken_tile_t* tile = snaken2d_large_tile(snaken, location, SNAKEN_FALSE, &local);
+    return tile == NULL ? 0x00 : tile->flags[local];
+}
+
+/// @brief Retrieves the snake occupancy of the provided location, treating missing tiles as empty.
+/// @param snaken The snaken to read the occupancy from.
+/// @param location The location to read.
+/// @return The location occupancy.
+static uint16_t snaken2d_large_occupancy(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location
+) {
+    snaken_cell_index_t local;
+    snaken_tile_t* tile = snaken2d_large_tile(snaken, location, SNAKEN_FALSE, &local);
+    return tile == NULL ? 0x00 : tile->occupancy[local];
+}
+
+/// @brief Adds [delta] snake sections to the occupancy of the provided location, allocating its tile if needed.
+/// @param snaken The snaken to update the occupancy of.
+/// @param location The location to update.
+/// @param delta The number of sections to add, negative to remove.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_large_occupy(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location,
+    snaken_world_size_t delta
+) {
+    snaken_cell_index_t local;
+    snaken_tile_t* tile = snaken2d_large_tile(snaken, location, SNAKEN_TRUE, &local);
+    if (tile == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    tile->occupancy[local] += delta;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Snake body functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided body section.
+/// @param snaken The snaken to read the section from.
+/// @param section The index of the section, 0 being the head.
+/// @return The section location.
+static snaken_cell_index_t snaken2d_large_section(
+    snaken2d_large_t* snaken,
+    snaken_world_size_t section
+) {
+    return snaken->snake_body[(snaken->snake_body_head + section) % snaken->snake_body_capacity];
+}
+
+/// @brief Appends a new body section on the tail, doubling the body capacity if needed.
+/// @param snaken The snaken to grow the snake of.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_large_append_section(
+    snaken2d_large_t* snaken
+) {
+    if (snaken->snake_length == snaken->snake_body_capacity) {
+        snaken_world_size_t new_capacity = snaken->snake_body_capacity * 2;
+        snaken_cell_index_t* new_body = (snaken_cell_index_t*) malloc(new_capacity * sizeof(snaken_cell_index_t));
+        if (new_body == NULL) {
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+
+        for (snaken_world_size_t i = 0; i < snaken->snake_length; i++) {
+            new_body[i] = snaken2d_large_section(snaken, i);
+        }
+
+        free(snaken->snake_body);
+        snaken->snake_body = new_body;
+        snaken->snake_body_capacity = new_capacity;
+        snaken->snake_body_head = 0;
+    }
+
+    snaken_cell_index_t tail = snaken2d_large_section(snaken, snaken->snake_length - 1);
+    snaken->snake_body[(snaken->snake_body_head + snaken->snake_length) % snaken->snake_body_capacity] = tail;
+    snaken->snake_length++;
+
+    return snaken2d_large_occupy(snaken, tail, 1);
+}
+
+/// @brief Computes a random location, within the apples spawn radius from the snake head if any.
+/// @param snaken The snaken to compute the location in.
+/// @return The computed location.
+static snaken_cell_index_t snaken2d_large_random_location(
+    snaken2d_large_t* snaken
+) {
+    // rand() only guarantees 15 random bits, so combine several calls to cover 64 bit ranges.
+    uint64_t x_bits = ((uint64_t) rand() << 45) ^ ((uint64_t) rand() << 30) ^ ((uint64_t) rand() << 15) ^ (uint64_t) rand();
+    uint64_t y_bits = ((uint64_t) rand() << 45) ^ ((uint64_t) rand() << 30) ^ ((uint64_t) rand() << 15) ^ (uint64_t) rand();
+
+    if (snaken->apples_spawn_radius <= 0) {
+        return IDX2D(
+            (snaken_cell_index_t) (x_bits % (uint64_t) snaken->world_width),
+            (snaken_cell_index_t) (y_bits % (uint64_t) snaken->world_height),
+            snaken->world_width
+        );
+    }
+
+    snaken_cell_index_t head = snaken2d_large_section(snaken, 0);
+    uint64_t spawn_diameter = (uint64_t) NH_DIAM_2D(snaken->apples_spawn_radius);
+
+    return IDX2D(
+        WRAP(head % snaken->world_width + (snaken_cell_index_t) (x_bits % spawn_diameter) - snaken->apples_spawn_radius, snaken->world_width),
+        WRAP(head / snaken->world_width + (snaken_cell_index_t) (y_bits % spawn_diameter) - snaken->apples_spawn_radius, snaken->world_height),
+        snaken->world_width
+    );
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_large_init(
+    snaken2d_large_t** snaken,
+    snaken_cell_index_t world_width,
+    snaken_cell_index_t world_height
+) {
+    // Make sure the world is not empty and its cells can all be addressed.
+    if (world_width <= 0 || world_height <= 0 || world_width > INT64_MAX / world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Allocate the snaken.
+    (*snaken) = (snaken2d_large_t*) malloc(sizeof(snaken2d_large_t));
+    if ((*snaken) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Store world size.
+    (*snaken)->world_width = world_width;
+    (*snaken)->world_height = world_height;
+
+    // Allocate the tile directory, empty.
+    (*snaken)->tiles_capacity = SNAKEN_DEFAULT_TILE_DIR_CAPACITY;
+    (*snaken)->tiles_count = 0;
+    (*snaken)->tiles = (snaken_tile_slot_t*) malloc((*snaken)->tiles_capacity * sizeof(snaken_tile_slot_t));
+    if ((*snaken)->tiles == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_cell_index_t i = 0; i < (*snaken)->tiles_capacity; i++) {
+        (*snaken)->tiles[i].key = -1;
+        (*snaken)->tiles[i].tile = NULL;
+    }
+    (*snaken)->last_tile.key = -1;
+    (*snaken)->last_tile.tile = NULL;
+
+    (*snaken)->walls_length = 0;
+
+    // Allocate snake body.
+    (*snaken)->snake_length = SNAKEN_STARTING_SNAKE_LENGTH;
+    (*snaken)->snake_body_capacity = SNAKEN_STARTING_SNAKE_LENGTH;
+    (*snaken)->snake_body_head = 0;
+    (*snaken)->snake_body = (snaken_cell_index_t*) malloc((*snaken)->snake_body_capacity * sizeof(snaken_cell_index_t));
+    if ((*snaken)->snake_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // The whole body starts in the starting hole, under the head.
+    snaken_cell_index_t start = IDX2D(world_width / 2, world_height / 2, world_width);
+    for (snaken_world_size_t i = 0; i < (*snaken)->snake_length; i++) {
+        (*snaken)->snake_body[i] = start;
+    }
+    snaken_error_code_t error = snaken2d_large_occupy(*snaken, start, (*snaken)->snake_length);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    (*snaken)->snake_speed = SNAKEN_DEFAULT_SNAKE_SPEED;
+    (*snaken)->snake_speed_step = 0;
+    (*snaken)->snake_stamina = SNAKEN_DEFAULT_SNAKE_STAMINA;
+    (*snaken)->snake_stamina_step = 0;
+    (*snaken)->snake_direction = SNAKEN_STARTING_SNAKE_DIR;
+    (*snaken)->self_intersects = SNAKEN_TRUE;
+    (*snaken)->snake_alive = SNAKEN_TRUE;
+    (*snaken)->snake_view_radius = SNAKEN_DEFAULT_SNAKE_VIEW_RADIUS;
+
+    // Allocate and populate apples.
+    (*snaken)->eaten_apples_count = 0;
+    (*snaken)->apples_spawn_radius = 0;
+    (*snaken)->apples_length = 0;
+    (*snaken)->apples = NULL;
+
+    return snaken2d_large_set_apples_count(*snaken, SNAKEN_DEFAULT_APPLES_LENGTH);
+}
+
+snaken_error_code_t snaken2d_large_destroy(
+    snaken2d_large_t* snaken
+) {
+    for (snaken_cell_index_t i = 0; i < snaken->tiles_capacity; i++) {
+        free(snaken->tiles[i].tile);
+    }
+    free(snaken->tiles);
+    free(snaken->snake_body);
+    free(snaken->apples);
+    free(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_large_tick(snaken2d_large_t* snaken) {
+    snaken_error_code_t error = SNAKEN_ERROR_NONE;
+
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    // 1: Move the snake along its facing direction.
+    snaken->snake_speed_step++;
+    if (snaken->snake_speed_step >= (snaken_snake_speed_t) (~snaken->snake_speed)) {
+        snaken->snake_speed_step = 0;
+
+        snaken_cell_index_t head = snaken2d_large_section(snaken, 0);
+        snaken_cell_index_t x_location = head % snaken->world_width;
+        snaken_cell_index_t y_location = head / snaken->world_width;
+
+        switch (snaken->snake_direction) {
+            case SNAKEN_UP:
+                head = IDX2D(x_location, WRAP(y_location - 1, snaken->world_height), snaken->world_width);
+                break;
+            case SNAKEN_LEFT:
+                head = IDX2D(WRAP(x_location - 1, snaken->world_width), y_location, snaken->world_width);
+                break;
+            case SNAKEN_DOWN:
+                head = IDX2D(x_location, WRAP(y_location + 1, snaken->world_height), snaken->world_width);
+                break;
+            case SNAKEN_RIGHT:
+                head = IDX2D(WRAP(x_location + 1, snaken->world_width), y_location, snaken->world_width);
+                break;
+            default:
+                break;
+        }
+
+        // Release the tail before moving the head backwards in the ring, since it could overwrite it.
+        error = snaken2d_large_occupy(snaken, snaken2d_large_section(snaken, snaken->snake_length - 1), -1);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+        snaken->snake_body_head = (snaken->snake_body_head + snaken->snake_body_capacity - 1) % snaken->snake_body_capacity;
+        snaken->snake_body[snaken->snake_body_head] = head;
+        error = snaken2d_large_occupy(snaken, head, 1);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    snaken_cell_index_t head = snaken2d_large_section(snaken, 0);
+    uint8_t head_flags = snaken2d_large_flags(snaken, head);
+
+    // 2: Let the snake eat any apple in its way.
+    if (head_flags & SNAKEN_TILE_APPLE) {
+        // Eating is rare compared to moving, so finding the apple is worth a scan rather than a per-cell index.
+        for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+            if (snaken->apples[i] != head) continue;
+
+            snaken->eaten_apples_count++;
+            snaken->snake_stamina_step = 0;
+
+            error = snaken2d_large_spawn_apple(snaken, i);
+            if (error != SNAKEN_ERROR_NONE) {
+                return error;
+            }
+
+            // If any apple was found, then no wall can, so just end here.
+            return snaken2d_large_append_section(snaken);
+        }
+    }
+
+    // 3: Check for walls.
+    if (head_flags & SNAKEN_TILE_WALL) {
+        snaken->snake_alive = SNAKEN_FALSE;
+        return SNAKEN_ERROR_NONE;
+    }
+
+    // 4: Check for body if so specified: any section other than the head on the head cell is hit.
+    if (snaken->self_intersects == SNAKEN_FALSE && snaken2d_large_occupancy(snaken, head) > 1) {
+        snaken->snake_alive = SNAKEN_FALSE;
+    }
+
+    // 5: Check for hunger.
+    snaken->snake_stamina_step++;
+    if (snaken->snake_stamina_step <= snaken->snake_stamina) return SNAKEN_ERROR_NONE;
+
+    // Reset hunger and chop the snake body off by one.
+    snaken->snake_stamina_step = 0;
+    error = snaken2d_large_occupy(snaken, snaken2d_large_section(snaken, snaken->snake_length - 1), -1);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+    snaken->snake_length--;
+
+    // Let the snake die of hunger.
+    if (snaken->snake_length <= 0) snaken->snake_alive = SNAKEN_FALSE;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_large_get_snake_section(
+    snaken2d_large_t* snaken,
+    snaken_world_size_t section,
+    snaken_cell_index_t* location
+) {
+    if (section < 0 || section >= snaken->snake_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    (*location) = snaken2d_large_section(snaken, section);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_get_cell(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location,
+    snaken_cell_type_t* cell_type
+) {
+    if (location < 0 || location / snaken->world_width >= snaken->world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken_cell_index_t local;
+    snaken_tile_t* tile = snaken2d_large_tile(snaken, location, SNAKEN_FALSE, &local);
+
+    if (snaken->snake_length > 0 && location == snaken2d_large_section(snaken, 0)) {
+        (*cell_type) = SNAKEN_SNAKE_HEAD;
+    } else if (tile == NULL) {
+        (*cell_type) = SNAKEN_EMPTY;
+    } else if (tile->occupancy[local] > 0) {
+        (*cell_type) = SNAKEN_SNAKE_BODY;
+    } else if (tile->flags[local] & SNAKEN_TILE_APPLE) {
+        (*cell_type) = SNAKEN_APPLE;
+    } else if (tile->flags[local] & SNAKEN_TILE_WALL) {
+        (*cell_type) = SNAKEN_WALL;
+    } else {
+        (*cell_type) = SNAKEN_EMPTY;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_get_snake_view(
+    snaken2d_large_t* snaken,
+    snaken_cell_type_t* view
+) {
+    if (snaken->snake_length <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken_world_size_t radius = snaken->snake_view_radius;
+    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(radius);
+    snaken_cell_index_t head = snaken2d_large_section(snaken, 0);
+    snaken_cell_index_t head_x = head % snaken->world_width;
+    snaken_cell_index_t head_y = head / snaken->world_width;
+
+    for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
+        for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
+            // Compute the unrotated view-space location according to snake direction, consistently with [snaken2d_get_snake_view].
+            snaken_world_size_t i;
+            snaken_world_size_t j;
+            switch (snaken->snake_direction) {
+                case SNAKEN_LEFT:
+                    i = y;
+                    j = snake_view_diameter - 1 - x;
+                    break;
+                case SNAKEN_RIGHT:
+                    i = snake_view_diameter - 1 - y;
+                    j = x;
+                    break;
+                case SNAKEN_DOWN:
+                    i = snake_view_diameter - 1 - x;
+                    j = snake_view_diameter - 1 - y;
+                    break;
+                case SNAKEN_UP:
+                default:
+                    i = x;
+                    j = y;
+                    break;
+            }
+
+            snaken2d_large_get_cell(
+                snaken,
+                IDX2D(WRAP(head_x - i + radius, snaken->world_width), WRAP(head_y - j + radius, snaken->world_height), snaken->world_width),
+                &(view[IDX2D(x, y, snake_view_diameter)])
+            );
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_large_set_snake_dir(snaken2d_large_t* snaken, snaken_dir_t direction) {
+    snaken->snake_direction = direction;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_turn_left(snaken2d_large_t* snaken) {
+    // Directions are enumerated counter-clockwise.
+    snaken->snake_direction = (snaken_dir_t) ((snaken->snake_direction + 1) % 4);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_turn_right(snaken2d_large_t* snaken) {
+    // Directions are enumerated counter-clockwise.
+    snaken->snake_direction = (snaken_dir_t) ((snaken->snake_direction + 3) % 4);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_snake_view_radius(snaken2d_large_t* snaken, snaken_world_size_t radius) {
+    snaken->snake_view_radius = radius;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_self_intersect(snaken2d_large_t* snaken, snaken_bool_t val) {
+    snaken->self_intersects = val;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_snake_speed(snaken2d_large_t* snaken, snaken_snake_speed_t speed) {
+    snaken->snake_speed = speed;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_snake_stamina(snaken2d_large_t* snaken, snaken_snake_stamina_t stamina) {
+    snaken->snake_stamina = stamina;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_apples_spawn_radius(snaken2d_large_t* snaken, snaken_cell_index_t radius) {
+    snaken->apples_spawn_radius = radius;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_set_apples_count(snaken2d_large_t* snaken, snaken_world_size_t apples_count) {
+    snaken_cell_index_t local;
+
+    // Save the old count for later use.
+    snaken_world_size_t old_apples_count = snaken->apples_length;
+
+    // If the amount of apples decreased, then remove the exceeding ones. Their tiles were allocated when they spawned.
+    for (snaken_world_size_t i = apples_count; i < old_apples_count; i++) {
+        snaken2d_large_tile(snaken, snaken->apples[i], SNAKEN_FALSE, &local)->flags[local] &= ~SNAKEN_TILE_APPLE;
+    }
+
+    // Resize the apples array.
+    snaken_cell_index_t* apples = (snaken_cell_index_t*) realloc(snaken->apples, apples_count * sizeof(snaken_cell_index_t));
+    if (apples_count > 0 && apples == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->apples = apples;
+    snaken->apples_length = apples_count;
+
+    // If the amount of apples increased, then spawn new ones.
+    for (snaken_world_size_t i = old_apples_count; i < snaken->apples_length; i++) {
+        // Mark the slot as empty, so that spawning does not release any cell.
+        snaken->apples[i] = -1;
+
+        snaken_error_code_t error = snaken2d_large_spawn_apple(snaken, i);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_spawn_apple(snaken2d_large_t* snaken, snaken_world_size_t index) {
+    snaken_cell_index_t local;
+
+    // Make sure the provided index is in range.
+    if (index < 0 || index >= snaken->apples_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Release the current apple cell.
+    if (snaken->apples[index] >= 0) {
+        snaken2d_large_tile(snaken, snaken->apples[index], SNAKEN_FALSE, &local)->flags[local] &= ~SNAKEN_TILE_APPLE;
+    }
+
+    snaken_cell_index_t apple_location;
+    do {
+        apple_location = snaken2d_large_random_location(snaken);
+    } while (snaken2d_large_flags(snaken, apple_location) & (SNAKEN_TILE_WALL | SNAKEN_TILE_APPLE));
+
+    snaken_tile_t* tile = snaken2d_large_tile(snaken, apple_location, SNAKEN_TRUE, &local);
+    if (tile == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    tile->flags[local] |= SNAKEN_TILE_APPLE;
+    snaken->apples[index] = apple_location;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_large_add_walls(snaken2d_large_t* snaken, snaken_cell_index_t walls_length, snaken_cell_index_t* walls) {
+    snaken_cell_index_t local;
+
+    // Make sure all walls are in range before changing anything.
+    for (snaken_cell_index_t i = 0; i < walls_length; i++) {
+        if (walls[i] < 0 || walls[i] / snaken->world_width >= snaken->world_height) {
+            return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+        }
+    }
+
+    for (snaken_cell_index_t i = 0; i < walls_length; i++) {
+        snaken_tile_t* tile = snaken2d_large_tile(snaken, walls[i], SNAKEN_TRUE, &local);
+        if (tile == NULL) {
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+
+        if (tile->flags[local] & SNAKEN_TILE_WALL) continue;
+
+        tile->flags[local] |= SNAKEN_TILE_WALL;
+        snaken->walls_length++;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -0,0 +1,323 @@
+/*
+*****************************************************************
+large.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __SNAKEN_LARGE__
+#define __SNAKEN_LARGE__
+
+#include "snaken.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Side of the square tiles large worlds are stored in. MUST be a power of 2.
+#define SNAKEN_TILE_SIZE 0x40
+#define SNAKEN_TILE_CELLS (SNAKEN_TILE_SIZE * SNAKEN_TILE_SIZE)
+
+// Initial number of slots in the tile directory. MUST be a power of 2.
+#define SNAKEN_DEFAULT_TILE_DIR_CAPACITY 0x40
+
+// Cell flags stored in tiles.
+#define SNAKEN_TILE_WALL 0x01u
+#define SNAKEN_TILE_APPLE 0x02u
+
+// This MUST be signed, as WRAP only works with signed types.
+// Large enough to address worlds far beyond what [snaken_world_size_t] can, both in side and in cells count.
+typedef int64_t snaken_cell_index_t;
+
+typedef struct {
+    // Flags ([SNAKEN_TILE_WALL], [SNAKEN_TILE_APPLE]) of every cell in the tile.
+    uint8_t flags[SNAKEN_TILE_CELLS];
+
+    // Number of snake sections (head included) on every cell in the tile.
+    uint16_t occupancy[SNAKEN_TILE_CELLS];
+} snaken_tile_t;
+
+typedef struct {
+    // Key of the tile in the slot, -1 if the slot is empty.
+    snaken_cell_index_t key;
+
+    // The tile in the slot.
+    snaken_tile_t* tile;
+} snaken_tile_slot_t;
+
+typedef struct {
+    // ################
+    // World properties.
+    // ################
+
+    // World size.
+    snaken_cell_index_t world_width;
+    snaken_cell_index_t world_height;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Tile directory.
+    // ################
+
+    // Number of slots in the directory, always a power of 2.
+    snaken_cell_index_t tiles_capacity;
+
+    // Number of allocated tiles. Only tiles something was ever written to are allocated.
+    snaken_cell_index_t tiles_count;
+
+    // Open addressing hash table from tile keys to tiles.
+    snaken_tile_slot_t* tiles;
+
+    // Last tile looked up, to skip hashing on consecutive lookups in the same tile.
+    snaken_tile_slot_t last_tile;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Walls locations.
+    // ################
+
+    // Number of walls. Walls only live in tiles, since a dense array would defeat sparse storage.
+    snaken_cell_index_t walls_length;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Apple locations.
+    // ################
+
+    // Apples array length.
+    snaken_world_size_t apples_length;
+
+    // Apples array.
+    snaken_cell_index_t* apples;
+
+    // Apples spawn at most this far from the snake head along each axis, 0 meaning anywhere in the world.
+    snaken_cell_index_t apples_spawn_radius;
+
+    // Total amount of apples eaten by the snake.
+    snaken_world_size_t eaten_apples_count;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snake locations.
+    // ################
+
+    // Snake length.
+    snaken_world_size_t snake_length;
+
+    // Capacity of the snake body buffer.
+    snaken_world_size_t snake_body_capacity;
+
+    // Index of the head in the snake body buffer.
+    snaken_world_size_t snake_body_head;
+
+    // Snake body, stored as a ring buffer starting at [snake_body_head], so that moving never shifts it.
+    snaken_cell_index_t* snake_body;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snake properties.
+    // ################
+
+    // Snake speed, see [snaken2d_t].
+    snaken_snake_speed_t snake_speed;
+
+    // Snake speed buildup, see [snaken2d_t].
+    snaken_snake_speed_t snake_speed_step;
+
+    // Snake stamina, see [snaken2d_t].
+    snaken_snake_stamina_t snake_stamina;
+
+    // Hunger buildup, see [snaken2d_t].
+    snaken_snake_stamina_t snake_stamina_step;
+
+    // The current snake direction.
+    snaken_dir_t snake_direction;
+
+    // Whether self intersection is enabled (can self intersect without dying) or not.
+    snaken_bool_t self_intersects;
+
+    // Tells whether the snake is currently alive or not.
+    snaken_bool_t snake_alive;
+
+    // Snake view radius.
+    snaken_world_size_t snake_view_radius;
+
+    // ################
+    // ################
+} snaken2d_large_t;
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+/// @brief Initializes the given large snaken with default values. No cell storage is allocated until touched.
+/// @param snaken The snaken to initialize.
+/// @param world_width The width of the snaken world.
+/// @param world_height The height of the snaken world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_init(
+    snaken2d_large_t** snaken,
+    snaken_cell_index_t world_width,
+    snaken_cell_index_t world_height
+);
+
+/// @brief Destroys the given snaken and frees memory for it, its tiles and its data.
+/// @param snaken The snaken to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_destroy(
+    snaken2d_large_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+/// @brief Performs a single run cycle in the provided snaken.
+/// @param snaken The snaken to run the loop in.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_tick(
+    snaken2d_large_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided snake body section.
+/// @param snaken The snaken to read the section from.
+/// @param section The index of the section, 0 being the head.
+/// @param location The resulting location.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_get_snake_section(
+    snaken2d_large_t* snaken,
+    snaken_world_size_t section,
+    snaken_cell_index_t* location
+);
+
+/// @brief Retrieves the type of the cell at the provided location, without allocating any tile.
+/// @param snaken The snaken to read the cell from.
+/// @param location The location of the cell.
+/// @param cell_type The resulting cell type.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_get_cell(
+    snaken2d_large_t* snaken,
+    snaken_cell_index_t location,
+    snaken_cell_type_t* cell_type
+);
+
+/// @brief Retrieves the current snake view and stores it in [view], laid out as [snaken2d_get_snake_view] does.
+/// @param snaken The snaken to extract the view from.
+/// @param view The view to populate.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_get_snake_view(
+    snaken2d_large_t* snaken,
+    snaken_cell_type_t* view
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+/// @brief Sets the snake facing direction.
+/// @param snaken The snaken to apply the snake direction to.
+/// @param direction The direction to set the snake to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_snake_dir(snaken2d_large_t* snaken, snaken_dir_t direction);
+
+/// @brief Turns the snake left relative to its current direction.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_turn_left(snaken2d_large_t* snaken);
+
+/// @brief Turns the snake right relative to its current direction.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_turn_right(snaken2d_large_t* snaken);
+
+/// @brief Sets the snake view radius.
+/// @param snaken The snaken to apply the snake view radius to.
+/// @param radius The radius to set the snake.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_snake_view_radius(snaken2d_large_t* snaken, snaken_world_size_t radius);
+
+/// @brief Sets whether the snake can self-intersect without dying or not.
+/// @param snaken The snaken to apply changes to.
+/// @param val The value to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_self_intersect(snaken2d_large_t* snaken, snaken_bool_t val);
+
+/// @brief Sets the snake speed in the provided snaken.
+/// @param snaken The snaken to apply the new speed to.
+/// @param speed The new speed to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_snake_speed(snaken2d_large_t* snaken, snaken_snake_speed_t speed);
+
+/// @brief Sets the snake stamina in the provided snaken.
+/// @param snaken The snaken to apply the new stamina to.
+/// @param stamina The new stamina to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_snake_stamina(snaken2d_large_t* snaken, snaken_snake_stamina_t stamina);
+
+/// @brief Sets how far from the snake head apples can spawn, so that foraging stays within a bounded set of tiles.
+/// @param snaken The snaken to apply changes to.
+/// @param radius The maximum distance along each axis, 0 meaning anywhere in the world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_apples_spawn_radius(snaken2d_large_t* snaken, snaken_cell_index_t radius);
+
+/// @brief Sets the provided snaken world to have [apples_count] apples at any time step.
+/// @param snaken The snaken to apply changes to.
+/// @param apples_count The amount of apples to be present at any time in the snaken world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_set_apples_count(snaken2d_large_t* snaken, snaken_world_size_t apples_count);
+
+/// @brief Updates the location of the apple at the provided index, avoiding walls and other apples.
+/// @param snaken The snaken to apply changes to.
+/// @param index The index of the apple to update.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_spawn_apple(snaken2d_large_t* snaken, snaken_world_size_t index);
+
+/// @brief Adds the provided walls to the provided snaken's world, skipping duplicates.
+/// @param snaken The snaken to apply walls to.
+/// @param walls_length The length of the walls array to add.
+/// @param walls The array of walls to add. Ownership stays with the caller.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_large_add_walls(snaken2d_large_t* snaken, snaken_cell_index_t walls_length, snaken_cell_index_t* walls);
+
+// ##########################################
+// ##########################################
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,593 @@
+#include "multi.h"
+
+// ##########################################
+// Snake body functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided body section.
+/// @param snake The snake to read the section of.
+/// @param section The index of the section, 0 being the head.
+/// @return The section location.
+static snaken_world_size_t snaken_snake_section(
+    snaken_snake_t* snake,
+    snaken_world_size_t section
+) {
+    return snake->body[(snake->body_head + section) % snake->body_capacity];
+}
+
+/// @brief Doubles the capacity of the provided snake body, laying sections out again from the head.
+/// @param snake The snake to grow the body of.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken_snake_grow_body(
+    snaken_snake_t* snake
+) {
+    snaken_world_size_t new_capacity = snake->body_capacity * 2;
+    snaken_world_size_t* new_body = (snaken_world_size_t*) malloc(new_capacity * sizeof(snaken_world_size_t));
+    if (new_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    for (snaken_world_size_t i = 0; i < snake->length; i++) {
+        new_body[i] = snaken_snake_section(snake, i);
+    }
+
+    free(snake->body);
+    snake->body = new_body;
+    snake->body_capacity = new_capacity;
+    snake->body_head = 0;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Checks whether the provided location is free from walls, apples and snakes.
+/// @param snaken The snaken the location belongs to.
+/// @param location The location to check.
+/// @return Whether the location is free.
+static snaken_bool_t snaken2d_multi_is_free(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t location
+) {
+    return !snaken->walls_map[location] && snaken->apples_map[location] < 0 && snaken->occupancy[location] == 0;
+}
+
+/// @brief Computes the location next to the provided one along the provided direction, wrapping around the world.
+/// @param snaken The snaken the location belongs to.
+/// @param location The starting location.
+/// @param direction The direction to move along.
+/// @return The next location.
+static snaken_world_size_t snaken2d_multi_next_location(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t location,
+    snaken_dir_t direction
+) {
+    snaken_world_size_t x_location = location % snaken->world_width;
+    snaken_world_size_t y_location = location / snaken->world_width;
+
+    switch (direction) {
+        case SNAKEN_UP:
+            return IDX2D(x_location, WRAP(y_location - 1, snaken->world_height), snaken->world_width);
+        case SNAKEN_LEFT:
+            return IDX2D(WRAP(x_location - 1, snaken->world_width), y_location, snaken->world_width);
+        case SNAKEN_DOWN:
+            return IDX2D(x_location, WRAP(y_location + 1, snaken->world_height), snaken->world_width);
+        case SNAKEN_RIGHT:
+            return IDX2D(WRAP(x_location + 1, snaken->world_width), y_location, snaken->world_width);
+        default:
+            return location;
+    }
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_multi_init(
+    snaken2d_multi_t** snaken,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t snakes_count
+) {
+    snaken_world_size_t world_size = world_width * world_height;
+
+    // Allocate the snaken.
+    (*snaken) = (snaken2d_multi_t*) malloc(sizeof(snaken2d_multi_t));
+    if ((*snaken) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Store world size.
+    (*snaken)->world_width = world_width;
+    (*snaken)->world_height = world_height;
+    (*snaken)->self_intersects = SNAKEN_TRUE;
+
+    // Allocate shared grids.
+    (*snaken)->walls_map = (uint8_t*) calloc(world_size, sizeof(uint8_t));
+    (*snaken)->apples_map = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    (*snaken)->occupancy = (snaken_world_size_t*) calloc(world_size, sizeof(snaken_world_size_t));
+    (*snaken)->owners = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    (*snaken)->next_heads = (snaken_world_size_t*) calloc(world_size, sizeof(snaken_world_size_t));
+    if ((*snaken)->walls_map == NULL ||
+        (*snaken)->apples_map == NULL ||
+        (*snaken)->occupancy == NULL ||
+        (*snaken)->owners == NULL ||
+        (*snaken)->next_heads == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        (*snaken)->apples_map[i] = -1;
+        (*snaken)->owners[i] = SNAKEN_NO_OWNER;
+    }
+
+    // Allocate walls.
+    (*snaken)->walls_length = 0;
+    (*snaken)->walls = NULL;
+
+    // Allocate snakes.
+    (*snaken)->snakes_count = snakes_count;
+    (*snaken)->snakes = (snaken_snake_t*) malloc(snakes_count * sizeof(snaken_snake_t));
+    if ((*snaken)->snakes == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Spread snakes on an evenly spaced grid, so that they all start on different cells.
+    snaken_world_size_t grid_columns = 1;
+    while (grid_columns * grid_columns < snakes_count) grid_columns++;
+    snaken_world_size_t grid_rows = snakes_count > 0 ? (snakes_count + grid_columns - 1) / grid_columns : 1;
+    if (grid_columns > world_width || grid_rows > world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    for (snaken_world_size_t k = 0; k < snakes_count; k++) {
+        snaken_snake_t* snake = &((*snaken)->snakes[k]);
+
+        snake->length = SNAKEN_STARTING_SNAKE_LENGTH;
+        snake->body_capacity = SNAKEN_STARTING_SNAKE_LENGTH;
+        snake->body_head = 0;
+        snake->body = (snaken_world_size_t*) malloc(snake->body_capacity * sizeof(snaken_world_size_t));
+        if (snake->body == NULL) {
+            return SNAKEN_ERROR_FAILED_ALLOC;
+        }
+
+        // The whole body starts in the starting hole, under the head.
+        snaken_world_size_t start = IDX2D(
+            world_width * (2 * (k % grid_columns) + 1) / (2 * grid_columns),
+            world_height * (2 * (k / grid_columns) + 1) / (2 * grid_rows),
+            world_width
+        );
+        for (snaken_world_size_t i = 0; i < snake->length; i++) {
+            snake->body[i] = start;
+        }
+        (*snaken)->occupancy[start] += snake->length;
+        (*snaken)->owners[start] = k;
+
+        snake->speed = SNAKEN_DEFAULT_SNAKE_SPEED;
+        snake->speed_step = 0;
+        snake->stamina = SNAKEN_DEFAULT_SNAKE_STAMINA;
+        snake->stamina_step = 0;
+        snake->direction = SNAKEN_STARTING_SNAKE_DIR;
+        snake->alive = SNAKEN_TRUE;
+        snake->eaten_apples_count = 0;
+        snake->moving = SNAKEN_FALSE;
+        snake->eating = SNAKEN_FALSE;
+        snake->next_head = start;
+    }
+
+    // Allocate and populate apples once snakes are in place, so that apples avoid them.
+    (*snaken)->apples_length = 0;
+    (*snaken)->apples = NULL;
+    (*snaken)->rng = ((uint64_t) rand() << 32) ^ (uint64_t) rand();
+
+    return snaken2d_multi_set_apples_count(*snaken, SNAKEN_DEFAULT_APPLES_LENGTH);
+}
+
+snaken_error_code_t snaken2d_multi_destroy(
+    snaken2d_multi_t* snaken
+) {
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        free(snaken->snakes[k].body);
+    }
+    free(snaken->snakes);
+    free(snaken->walls);
+    free(snaken->walls_map);
+    free(snaken->apples);
+    free(snaken->apples_map);
+    free(snaken->occupancy);
+    free(snaken->owners);
+    free(snaken->next_heads);
+    free(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_multi_tick(
+    snaken2d_multi_t* snaken
+) {
+    snaken_error_code_t error = SNAKEN_ERROR_NONE;
+
+    // 1: Plan all moves, registering target cells and releasing the tails that are about to leave.
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        snaken_snake_t* snake = &(snaken->snakes[k]);
+        snake->moving = SNAKEN_FALSE;
+        snake->eating = SNAKEN_FALSE;
+
+        if (!snake->alive) continue;
+
+        snake->speed_step++;
+        if (snake->speed_step < (snaken_snake_speed_t) (~snake->speed)) continue;
+        snake->speed_step = 0;
+
+        snake->moving = SNAKEN_TRUE;
+        snake->next_head = snaken2d_multi_next_location(snaken, snaken_snake_section(snake, 0), snake->direction);
+        snake->eating = snaken->apples_map[snake->next_head] >= 0;
+        snaken->next_heads[snake->next_head]++;
+
+        // A growing snake keeps its tail in place.
+        if (!snake->eating) snaken->occupancy[snaken_snake_section(snake, snake->length - 1)]--;
+    }
+
+    // 2: Resolve all collisions against the planned state, so that no snake has an advantage over the others.
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        snaken_snake_t* snake = &(snaken->snakes[k]);
+
+        if (!snake->moving) continue;
+
+        snaken_world_size_t target = snake->next_head;
+        snaken_bool_t head_to_head = snaken->next_heads[target] > 1;
+        snaken_bool_t head_to_body = snaken->occupancy[target] > 0 && (snaken->owners[target] != k || !snaken->self_intersects);
+
+        if (snaken->walls_map[target] || head_to_head || head_to_body) snake->alive = SNAKEN_FALSE;
+    }
+
+    // 3: Apply moves and clear dead snakes out of the world.
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        snaken_snake_t* snake = &(snaken->snakes[k]);
+
+        if (!snake->moving) continue;
+
+        snaken->next_heads[snake->next_head] = 0;
+
+        if (!snake->alive) {
+            // The tail was already released unless the snake was eating.
+            snaken_world_size_t occupied_length = snake->eating ? snake->length : snake->length - 1;
+            for (snaken_world_size_t i = 0; i < occupied_length; i++) {
+                snaken->occupancy[snaken_snake_section(snake, i)]--;
+            }
+            continue;
+        }
+
+        if (snake->eating) {
+            if (snake->length == snake->body_capacity) {
+                error = snaken_snake_grow_body(snake);
+                if (error != SNAKEN_ERROR_NONE) {
+                    return error;
+                }
+            }
+            snake->length++;
+        }
+
+        // Moving the head backwards in the ring overwrites the old tail, unless the snake grew.
+        snake->body_head = (snake->body_head + snake->body_capacity - 1) % snake->body_capacity;
+        snake->body[snake->body_head] = snake->next_head;
+        snaken->occupancy[snake->next_head]++;
+        snaken->owners[snake->next_head] = k;
+    }
+
+    // 4: Let snakes eat apples, now that all snakes are in place and new apples can avoid them.
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        snaken_snake_t* snake = &(snaken->snakes[k]);
+
+        if (!snake->alive || !snake->eating) continue;
+
+        snake->eaten_apples_count++;
+        snake->stamina_step = 0;
+
+        error = snaken2d_multi_spawn_apple(snaken, snaken->apples_map[snake->next_head]);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    // 5: Check for hunger.
+    for (snaken_world_size_t k = 0; k < snaken->snakes_count; k++) {
+        snaken_snake_t* snake = &(snaken->snakes[k]);
+
+        if (!snake->alive || snake->eating) continue;
+
+        snake->stamina_step++;
+        if (snake->stamina_step <= snake->stamina) continue;
+
+        // Reset hunger and chop the snake body off by one.
+        snake->stamina_step = 0;
+        snaken->occupancy[snaken_snake_section(snake, snake->length - 1)]--;
+        snake->length--;
+
+        // Let the snake die of hunger.
+        if (snake->length <= 0) snake->alive = SNAKEN_FALSE;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_multi_get_section(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t snake,
+    snaken_world_size_t section,
+    snaken_world_size_t* location
+) {
+    if (snake < 0 || snake >= snaken->snakes_count || section < 0 || section >= snaken->snakes[snake].length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    (*location) = snaken_snake_section(&(snaken->snakes[snake]), section);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_get_snake_view(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t snake,
+    snaken_world_size_t radius,
+    snaken_cell_type_t* view
+) {
+    if (snake < 0 || snake >= snaken->snakes_count || snaken->snakes[snake].length <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken_snake_t* viewer = &(snaken->snakes[snake]);
+    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(radius);
+    snaken_world_size_t head = snaken_snake_section(viewer, 0);
+    snaken_world_size_t head_x = head % snaken->world_width;
+    snaken_world_size_t head_y = head / snaken->world_width;
+
+    for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
+        for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
+            // Compute the unrotated view-space location according to snake direction, consistently with [snaken2d_get_snake_view].
+            snaken_world_size_t i;
+            snaken_world_size_t j;
+            switch (viewer->direction) {
+                case SNAKEN_LEFT:
+                    i = y;
+                    j = snake_view_diameter - 1 - x;
+                    break;
+                case SNAKEN_RIGHT:
+                    i = snake_view_diameter - 1 - y;
+                    j = x;
+                    break;
+                case SNAKEN_DOWN:
+                    i = snake_view_diameter - 1 - x;
+                    j = snake_view_diameter - 1 - y;
+                    break;
+                case SNAKEN_UP:
+                default:
+                    i = x;
+                    j = y;
+                    break;
+            }
+
+            snaken_world_size_t location = IDX2D(
+                WRAP(head_x - i + radius, snaken->world_width),
+                WRAP(head_y - j + radius, snaken->world_height),
+                snaken->world_width
+            );
+            snaken_cell_type_t* cell = &(view[IDX2D(x, y, snake_view_diameter)]);
+
+            // Every lookup goes through the shared grids, so the view costs nothing more with more snakes.
+            if (snaken->occupancy[location] > 0) {
+                snaken_snake_t* owner = &(snaken->snakes[snaken->owners[location]]);
+                (*cell) = snaken_snake_section(owner, 0) == location ? SNAKEN_SNAKE_HEAD : SNAKEN_SNAKE_BODY;
+            } else if (snaken->apples_map[location] >= 0) {
+                (*cell) = SNAKEN_APPLE;
+            } else if (snaken->walls_map[location]) {
+                (*cell) = SNAKEN_WALL;
+            } else {
+                (*cell) = SNAKEN_EMPTY;
+            }
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_multi_set_snake_dir(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_dir_t direction) {
+    if (snake < 0 || snake >= snaken->snakes_count) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken->snakes[snake].direction = direction;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_turn_left(snaken2d_multi_t* snaken, snaken_world_size_t snake) {
+    if (snake < 0 || snake >= snaken->snakes_count) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Directions are enumerated counter-clockwise.
+    snaken->snakes[snake].direction = (snaken_dir_t) ((snaken->snakes[snake].direction + 1) % 4);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_turn_right(snaken2d_multi_t* snaken, snaken_world_size_t snake) {
+    if (snake < 0 || snake >= snaken->snakes_count) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Directions are enumerated counter-clockwise.
+    snaken->snakes[snake].direction = (snaken_dir_t) ((snaken->snakes[snake].direction + 3) % 4);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_set_snake_speed(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_snake_speed_t speed) {
+    if (snake < 0 || snake >= snaken->snakes_count) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken->snakes[snake].speed = speed;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_set_snake_stamina(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_snake_stamina_t stamina) {
+    if (snake < 0 || snake >= snaken->snakes_count) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken->snakes[snake].stamina = stamina;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_set_self_intersect(snaken2d_multi_t* snaken, snaken_bool_t val) {
+    snaken->self_intersects = val;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_set_seed(snaken2d_multi_t* snaken, uint64_t seed) {
+    snaken->rng = seed;
+
+    // Release all apples first, so that respawned ones only avoid each other in spawn order.
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        if (snaken->apples[i] >= 0) snaken->apples_map[snaken->apples[i]] = -1;
+        snaken->apples[i] = -1;
+    }
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken2d_multi_spawn_apple(snaken, i);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_set_apples_count(snaken2d_multi_t* snaken, snaken_world_size_t apples_count) {
+    // Save the old count for later use.
+    snaken_world_size_t old_apples_count = snaken->apples_length;
+
+    // If the amount of apples decreased, then remove the exceeding ones.
+    for (snaken_world_size_t i = apples_count; i < old_apples_count; i++) {
+        if (snaken->apples[i] >= 0) snaken->apples_map[snaken->apples[i]] = -1;
+    }
+
+    // Resize the apples array.
+    snaken_world_size_t* apples = (snaken_world_size_t*) realloc(snaken->apples, apples_count * sizeof(snaken_world_size_t));
+    if (apples_count > 0 && apples == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->apples = apples;
+    snaken->apples_length = apples_count;
+
+    // If the amount of apples increased, then spawn new ones.
+    for (snaken_world_size_t i = old_apples_count; i < snaken->apples_length; i++) {
+        // Mark the slot as empty, so that spawning does not release any cell.
+        snaken->apples[i] = -1;
+        snaken2d_multi_spawn_apple(snaken, i);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_spawn_apple(snaken2d_multi_t* snaken, snaken_world_size_t index) {
+    // Make sure the provided index is in range.
+    if (index < 0 || index >= snaken->apples_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Release the current apple cell.
+    if (snaken->apples[index] >= 0 && snaken->apples_map[snaken->apples[index]] == index) {
+        snaken->apples_map[snaken->apples[index]] = -1;
+    }
+
+    snaken->apples[index] = -1;
+
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+    snaken_world_size_t apple_location = -1;
+
+    // Random picks find a free cell quickly unless the world is crowded, so only try as many as there are cells.
+    // Every check is a single grid lookup, regardless of the number of walls, apples and snakes.
+    for (snaken_world_size_t i = 0; i < world_size && apple_location < 0; i++) {
+        snaken_world_size_t location = IDX2D(
+            snaken_rng_range(&(snaken->rng), snaken->world_width),
+            snaken_rng_range(&(snaken->rng), snaken->world_height),
+            snaken->world_width
+        );
+        if (snaken2d_multi_is_free(snaken, location)) apple_location = location;
+    }
+
+    // Crowded worlds are scanned from a random cell instead, leaving the apple out if no cell is free.
+    snaken_world_size_t start = snaken_rng_range(&(snaken->rng), world_size);
+    for (snaken_world_size_t i = 0; i < world_size && apple_location < 0; i++) {
+        snaken_world_size_t location = (start + i) % world_size;
+        if (snaken2d_multi_is_free(snaken, location)) apple_location = location;
+    }
+    if (apple_location < 0) return SNAKEN_ERROR_NONE;
+
+    snaken->apples[index] = apple_location;
+    snaken->apples_map[apple_location] = index;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_multi_add_walls(snaken2d_multi_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+
+    // Make sure all walls are in range before changing anything.
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        if (walls[i] < 0 || walls[i] >= world_size) {
+            return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+        }
+    }
+
+    // Resize the walls array for the worst case, then shrink it back once duplicates are skipped.
+    snaken_world_size_t* new_walls = (snaken_world_size_t*) realloc(snaken->walls, (snaken->walls_length + walls_length) * sizeof(snaken_world_size_t));
+    if (snaken->walls_length + walls_length > 0 && new_walls == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->walls = new_walls;
+
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        if (snaken->walls_map[walls[i]]) continue;
+
+        snaken->walls_map[walls[i]] = SNAKEN_TRUE;
+        snaken->walls[snaken->walls_length++] = walls[i];
+    }
+
+    if (snaken->walls_length > 0) {
+        new_walls = (snaken_world_size_t*) realloc(snaken->walls, snaken->walls_length * sizeof(snaken_world_size_t));
+        if (new_walls != NULL) snaken->walls = new_walls;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -0,0 +1,331 @@
+/*
+*****************************************************************
+multi.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __SNAKEN_MULTI__
+#define __SNAKEN_MULTI__
+
+#include "snaken.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Owner value of cells not occupied by any snake.
+#define SNAKEN_NO_OWNER -1
+
+typedef struct {
+    // ################
+    // Snake locations.
+    // ################
+
+    // Snake length.
+    snaken_world_size_t length;
+
+    // Capacity of the body buffer.
+    snaken_world_size_t body_capacity;
+
+    // Index of the head in the body buffer.
+    snaken_world_size_t body_head;
+
+    // Snake body, stored as a ring buffer starting at [body_head], so that moving never shifts it.
+    snaken_world_size_t* body;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snake properties.
+    // ################
+
+    // Snake speed, see [snaken2d_t].
+    snaken_snake_speed_t speed;
+
+    // Snake speed buildup, see [snaken2d_t].
+    snaken_snake_speed_t speed_step;
+
+    // Snake stamina, see [snaken2d_t].
+    snaken_snake_stamina_t stamina;
+
+    // Hunger buildup, see [snaken2d_t].
+    snaken_snake_stamina_t stamina_step;
+
+    // The current snake direction.
+    snaken_dir_t direction;
+
+    // Tells whether the snake is currently alive or not.
+    snaken_bool_t alive;
+
+    // Total amount of apples eaten by the snake.
+    snaken_world_size_t eaten_apples_count;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Tick scratch.
+    // ################
+
+    // Whether the snake moves in the current tick.
+    snaken_bool_t moving;
+
+    // Whether the snake eats an apple in the current tick.
+    snaken_bool_t eating;
+
+    // Head location the snake moves to in the current tick.
+    snaken_world_size_t next_head;
+
+    // ################
+    // ################
+} snaken_snake_t;
+
+typedef struct {
+    // ################
+    // World properties.
+    // ################
+
+    // World size.
+    snaken_world_size_t world_width;
+    snaken_world_size_t world_height;
+
+    // Whether snakes can self intersect without dying or not. Snakes never intersect each other.
+    snaken_bool_t self_intersects;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Walls locations.
+    // ################
+
+    // Length of walls array.
+    snaken_world_size_t walls_length;
+
+    // Walls array.
+    snaken_world_size_t* walls;
+
+    // Whether every cell holds a wall or not.
+    uint8_t* walls_map;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Apple locations.
+    // ################
+
+    // Apples array length.
+    snaken_world_size_t apples_length;
+
+    // Apples array, -1 for apples left out because no cell was free.
+    snaken_world_size_t* apples;
+
+    // Index of the apple held by every cell, -1 if none. Apples never share a cell.
+    snaken_world_size_t* apples_map;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Randomness.
+    // ################
+
+    // Generator of apple locations, seeded from rand() on init or explicitly by [snaken2d_multi_set_seed].
+    snaken_rng_t rng;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snakes.
+    // ################
+
+    // Number of snakes.
+    snaken_world_size_t snakes_count;
+
+    // Snakes array.
+    snaken_snake_t* snakes;
+
+    // Number of snake sections (heads included) on every cell.
+    snaken_world_size_t* occupancy;
+
+    // Index of the snake occupying every cell, [SNAKEN_NO_OWNER] if none.
+    snaken_world_size_t* owners;
+
+    // Number of snakes moving their head to every cell in the current tick.
+    snaken_world_size_t* next_heads;
+
+    // ################
+    // ################
+} snaken2d_multi_t;
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+/// @brief Initializes the given multi-snake snaken with default values, spreading snakes evenly across the world.
+/// @param snaken The snaken to initialize.
+/// @param world_width The width of the snaken world.
+/// @param world_height The height of the snaken world.
+/// @param snakes_count The number of snakes in the world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_init(
+    snaken2d_multi_t** snaken,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t snakes_count
+);
+
+/// @brief Destroys the given snaken and frees memory for it and its data.
+/// @param snaken The snaken to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_destroy(
+    snaken2d_multi_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+/// @brief Performs a single run cycle in the provided snaken, moving all snakes at once.
+/// Head-to-head and head-to-body collisions are resolved in a single pass over the shared occupancy grid,
+/// so a tick costs time linear in the number of snakes.
+/// @param snaken The snaken to run the loop in.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_tick(
+    snaken2d_multi_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided section of the provided snake.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @param section The index of the section, 0 being the head.
+/// @param location The resulting location.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_get_section(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t snake,
+    snaken_world_size_t section,
+    snaken_world_size_t* location
+);
+
+/// @brief Retrieves the current view of the provided snake and stores it in [view].
+/// Other snakes are reported as body, except for their heads.
+/// @param snaken The snaken to extract the view from.
+/// @param snake The index of the snake.
+/// @param radius The radius of the view.
+/// @param view The view to populate.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_get_snake_view(
+    snaken2d_multi_t* snaken,
+    snaken_world_size_t snake,
+    snaken_world_size_t radius,
+    snaken_cell_type_t* view
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+/// @brief Sets the facing direction of the provided snake.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @param direction The direction to set the snake to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_snake_dir(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_dir_t direction);
+
+/// @brief Turns the provided snake left relative to its current direction.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_turn_left(snaken2d_multi_t* snaken, snaken_world_size_t snake);
+
+/// @brief Turns the provided snake right relative to its current direction.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_turn_right(snaken2d_multi_t* snaken, snaken_world_size_t snake);
+
+/// @brief Sets the speed of the provided snake.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @param speed The new speed to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_snake_speed(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_snake_speed_t speed);
+
+/// @brief Sets the stamina of the provided snake.
+/// @param snaken The snaken the snake lives in.
+/// @param snake The index of the snake.
+/// @param stamina The new stamina to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_snake_stamina(snaken2d_multi_t* snaken, snaken_world_size_t snake, snaken_snake_stamina_t stamina);
+
+/// @brief Sets whether snakes can self-intersect without dying or not.
+/// @param snaken The snaken to apply changes to.
+/// @param val The value to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_self_intersect(snaken2d_multi_t* snaken, snaken_bool_t val);
+
+/// @brief Reseeds the apple locations generator of the provided snaken and respawns all apples from it.
+/// The same seed on the same configuration always yields the same apples.
+/// @param snaken The snaken to reseed.
+/// @param seed The seed to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_seed(snaken2d_multi_t* snaken, uint64_t seed);
+
+/// @brief Sets the provided snaken world to have [apples_count] apples at any time step.
+/// @param snaken The snaken to apply changes to.
+/// @param apples_count The amount of apples to be present at any time in the snaken world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_set_apples_count(snaken2d_multi_t* snaken, snaken_world_size_t apples_count);
+
+/// @brief Updates the location of the apple at the provided index, avoiding walls, snakes and other apples.
+/// The apple is left out, with a -1 location, if no cell is free.
+/// @param snaken The snaken to apply changes to.
+/// @param index The index of the apple to update.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_spawn_apple(snaken2d_multi_t* snaken, snaken_world_size_t index);
+
+/// @brief Adds the provided walls to the existing walls in the provided snaken's world, skipping duplicates.
+/// @param snaken The snaken to apply walls to.
+/// @param walls_length The length of the walls array to add.
+/// @param walls The array of walls to add. Ownership stays with the caller.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_multi_add_walls(snaken2d_multi_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls);
+
+// ##########################################
+// ##########################################
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
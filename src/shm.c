@@ -0,0 +1,498 @@
+// Needed for shm_open, ftruncate, mmap, kill and syscall.
+#define _GNU_SOURCE
+
+#include "shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// ##########################################
+// Synchronization functions.
+// ##########################################
+
+/// @brief Puts the calling thread to sleep as long as [word] holds [value]. Can return spuriously.
+/// @param word The shared word to wait on.
+/// @param value The value to wait for [word] to change from.
+static void snaken_shm_sleep(uint32_t* word, uint32_t value) {
+#ifdef __linux__
+    // Process-shared futex, since the word lives in a segment mapped by different processes.
+    syscall(SYS_futex, word, FUTEX_WAIT, value, NULL, NULL, 0);
+#else
+    (void) word;
+    (void) value;
+    sched_yield();
+#endif
+}
+
+/// @brief Wakes up all threads sleeping on [word].
+/// @param word The shared word to wake sleepers of.
+static void snaken_shm_wake(uint32_t* word) {
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    (void) word;
+#endif
+}
+
+/// @brief Waits for the provided sequence counter to change from [value], or for shutdown to be requested.
+/// Spins for a while first, so that no syscall is performed as long as the other side keeps up.
+/// @param header The header of the segment.
+/// @param seq The sequence counter to wait on.
+/// @param waiters The sleepers counter of [seq].
+/// @param value The value to wait for [seq] to change from.
+/// @param spin_count The number of polls before sleeping.
+static void snaken_shm_wait(
+    snaken_shm_header_t* header,
+    uint32_t* seq,
+    uint32_t* waiters,
+    uint32_t value,
+    uint32_t spin_count
+) {
+    for (uint32_t i = 0; i < spin_count; i++) {
+        if (__atomic_load_n(seq, __ATOMIC_SEQ_CST) != value || __atomic_load_n(&(header->shutdown), __ATOMIC_SEQ_CST)) return;
+    }
+
+    while (__atomic_load_n(seq, __ATOMIC_SEQ_CST) == value && !__atomic_load_n(&(header->shutdown), __ATOMIC_SEQ_CST)) {
+        // Announce the sleep before checking the counter again in the kernel: the publisher stores the counter before
+        // reading the sleepers count, so either it sees this sleeper or the futex sees the new counter.
+        __atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+        snaken_shm_sleep(seq, value);
+        __atomic_fetch_sub(waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+/// @brief Publishes a new value of the provided sequence counter, waking sleepers only if there are any.
+/// @param seq The sequence counter to publish.
+/// @param waiters The sleepers counter of [seq].
+/// @param value The value to publish.
+static void snaken_shm_publish(
+    uint32_t* seq,
+    uint32_t* waiters,
+    uint32_t value
+) {
+    // Sequentially consistent, so that the sleepers count is read after the counter is stored.
+    __atomic_store_n(seq, value, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) snaken_shm_wake(seq);
+}
+
+/// @brief Computes how many polls a waiting side should perform before sleeping.
+/// @return The number of polls.
+static uint32_t snaken_shm_spin_count(void) {
+    // Spinning only helps if the other side can make progress meanwhile, which takes another CPU.
+    return sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SNAKEN_SHM_SPIN_COUNT : 0;
+}
+
+/// @brief Computes the address of the provided frame of a ring.
+/// @param header The header of the segment.
+/// @param offset The offset of the ring.
+/// @param frame_size The size of every frame in the ring.
+/// @param seq The number of the step the frame belongs to.
+/// @return The address of the frame.
+static void* snaken_shm_frame(
+    snaken_shm_header_t* header,
+    uint64_t offset,
+    uint64_t frame_size,
+    uint32_t seq
+) {
+    return (uint8_t*) header + offset + (seq % (uint32_t) header->depth) * frame_size;
+}
+
+/// @brief Rounds the provided size up to [SNAKEN_OBS_ALIGNMENT].
+/// @param size The size to round.
+/// @return The rounded size.
+static uint64_t snaken_shm_align(uint64_t size) {
+    return (size + SNAKEN_OBS_ALIGNMENT - 1) / SNAKEN_OBS_ALIGNMENT * SNAKEN_OBS_ALIGNMENT;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Server functions.
+// ##########################################
+
+/// @brief Tells whether the existing segment with the provided name is still owned by a running server.
+/// Segments that cannot be read or were never fully initialized are assumed to be owned, so that they are never taken over by mistake.
+/// @param name The name of the segment.
+/// @return Whether the segment owner may still be running.
+static snaken_bool_t snaken_shm_owner_alive(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return SNAKEN_TRUE;
+
+    struct stat segment_stat;
+    if (fstat(fd, &segment_stat) != 0 || (uint64_t) segment_stat.st_size < sizeof(snaken_shm_header_t)) {
+        close(fd);
+        return SNAKEN_TRUE;
+    }
+    snaken_shm_header_t* header = (snaken_shm_header_t*) mmap(NULL, sizeof(snaken_shm_header_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (header == MAP_FAILED) return SNAKEN_TRUE;
+
+    snaken_bool_t alive = SNAKEN_TRUE;
+    if (header->magic == SNAKEN_SHM_MAGIC && header->version == SNAKEN_SHM_VERSION) {
+        // Only a missing process proves the owner is gone: any other failure may just be a lack of permissions.
+        alive = kill((pid_t) header->owner_pid, 0) == 0 || errno != ESRCH;
+    }
+    munmap(header, sizeof(snaken_shm_header_t));
+
+    return alive;
+}
+
+/// @brief Steps all worlds with the actions of the provided step and writes their results.
+/// @param server The server to step.
+/// @param seq The number of the step, 0 for the initial observations.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken_shm_server_step(
+    snaken_shm_server_t* server,
+    uint32_t seq
+) {
+    snaken_shm_header_t* header = server->header;
+    uint8_t* actions = (uint8_t*) snaken_shm_frame(header, header->actions_offset, header->actions_frame_size, seq);
+    float* rewards = (float*) snaken_shm_frame(header, header->rewards_offset, header->rewards_frame_size, seq);
+    uint8_t* dones = (uint8_t*) snaken_shm_frame(header, header->dones_offset, header->dones_frame_size, seq);
+    snaken_error_code_t error = SNAKEN_ERROR_NONE;
+
+    #pragma omp parallel for schedule(static)
+    for (snaken_world_size_t n = 0; n < header->worlds_count; n++) {
+        snaken2d_t* world = server->worlds[n];
+
+        rewards[n] = 0.0f;
+        dones[n] = SNAKEN_FALSE;
+
+        // The initial step carries no actions.
+        if (seq == 0) continue;
+
+        snaken2d_apply_action(world, actions[n]);
+
+        snaken_error_code_t world_error = snaken2d_tick(world);
+
+        rewards[n] = (float) (world->eaten_apples_count - server->eaten_apples[n]);
+        server->eaten_apples[n] = world->eaten_apples_count;
+
+        if (world_error == SNAKEN_ERROR_NONE && !world->snake_alive) {
+            rewards[n] -= 1.0f;
+            dones[n] = SNAKEN_TRUE;
+
+            // Reset the world in place, so that the observation is the first of the next episode.
+            // Resetting rather than recreating keeps walls and settings across episodes.
+            world_error = snaken2d_reset(world, snaken_rng_next(&(world->rng)));
+            server->eaten_apples[n] = 0;
+        }
+
+        if (world_error != SNAKEN_ERROR_NONE) {
+            #pragma omp atomic write
+            error = world_error;
+        }
+    }
+
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    return snaken2d_get_obs_batch(
+        server->worlds,
+        header->worlds_count,
+        &(header->layout),
+        (snaken_obs_t*) snaken_shm_frame(header, header->views_offset, header->views_frame_size, seq),
+        (snaken_obs_t*) snaken_shm_frame(header, header->features_offset, header->features_frame_size, seq)
+    );
+}
+
+snaken_error_code_t snaken_shm_server_init(
+    snaken_shm_server_t** server,
+    const char* name,
+    snaken_world_size_t worlds_count,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t view_radius,
+    snaken_world_size_t depth
+) {
+    snaken_error_code_t error;
+
+    if (worlds_count <= 0 || depth < 2 || strlen(name) >= SNAKEN_SHM_NAME_LENGTH) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Allocate the server.
+    (*server) = (snaken_shm_server_t*) malloc(sizeof(snaken_shm_server_t));
+    if ((*server) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    strcpy((*server)->name, name);
+    (*server)->spin_count = snaken_shm_spin_count();
+
+    // Compute the segment layout: every ring starts aligned, and so does every frame.
+    snaken_shm_header_t layout_header;
+    error = snaken_obs_layout_init(&(layout_header.layout), view_radius);
+    if (error != SNAKEN_ERROR_NONE) {
+        free(*server);
+        return error;
+    }
+    layout_header.actions_frame_size = snaken_shm_align(worlds_count * sizeof(uint8_t));
+    layout_header.views_frame_size = snaken_shm_align((uint64_t) worlds_count * layout_header.layout.view_stride * sizeof(snaken_obs_t));
+    layout_header.features_frame_size = snaken_shm_align((uint64_t) worlds_count * layout_header.layout.features_stride * sizeof(snaken_obs_t));
+    layout_header.rewards_frame_size = snaken_shm_align(worlds_count * sizeof(float));
+    layout_header.dones_frame_size = snaken_shm_align(worlds_count * sizeof(uint8_t));
+
+    layout_header.actions_offset = snaken_shm_align(sizeof(snaken_shm_header_t));
+    layout_header.views_offset = layout_header.actions_offset + depth * layout_header.actions_frame_size;
+    layout_header.features_offset = layout_header.views_offset + depth * layout_header.views_frame_size;
+    layout_header.rewards_offset = layout_header.features_offset + depth * layout_header.features_frame_size;
+    layout_header.dones_offset = layout_header.rewards_offset + depth * layout_header.rewards_frame_size;
+    layout_header.size = layout_header.dones_offset + depth * layout_header.dones_frame_size;
+
+    // Create and map the segment, only replacing an existing one if it is a stale one left by a crashed server.
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST && !snaken_shm_owner_alive(name)) {
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        free(*server);
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+    if (ftruncate(fd, (off_t) layout_header.size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        free(*server);
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+    void* segment = mmap(NULL, layout_header.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        shm_unlink(name);
+        free(*server);
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+
+    snaken_shm_header_t* header = (snaken_shm_header_t*) segment;
+    (*server)->header = header;
+    header->size = layout_header.size;
+    header->owner_pid = (int32_t) getpid();
+    header->worlds_count = worlds_count;
+    header->world_width = world_width;
+    header->world_height = world_height;
+    header->view_radius = view_radius;
+    header->depth = depth;
+    header->layout = layout_header.layout;
+    header->actions_offset = layout_header.actions_offset;
+    header->actions_frame_size = layout_header.actions_frame_size;
+    header->views_offset = layout_header.views_offset;
+    header->views_frame_size = layout_header.views_frame_size;
+    header->features_offset = layout_header.features_offset;
+    header->features_frame_size = layout_header.features_frame_size;
+    header->rewards_offset = layout_header.rewards_offset;
+    header->rewards_frame_size = layout_header.rewards_frame_size;
+    header->dones_offset = layout_header.dones_offset;
+    header->dones_frame_size = layout_header.dones_frame_size;
+    header->requests_seq = 0;
+    header->requests_waiters = 0;
+    header->results_seq = 0;
+    header->results_waiters = 0;
+    header->shutdown = 0;
+
+    // Allocate the hosted worlds.
+    snaken_world_size_t worlds_initialized = 0;
+    (*server)->worlds = (snaken2d_t**) malloc(worlds_count * sizeof(snaken2d_t*));
+    (*server)->eaten_apples = (snaken_world_size_t*) calloc(worlds_count, sizeof(snaken_world_size_t));
+    if ((*server)->worlds == NULL || (*server)->eaten_apples == NULL) {
+        error = SNAKEN_ERROR_FAILED_ALLOC;
+        goto failed;
+    }
+    for (; worlds_initialized < worlds_count; worlds_initialized++) {
+        error = snaken2d_init(&((*server)->worlds[worlds_initialized]), world_width, world_height);
+        if (error != SNAKEN_ERROR_NONE) {
+            goto failed;
+        }
+    }
+
+    // Publish the initial observations as the results of step 0.
+    error = snaken_shm_server_step(*server, 0);
+    if (error != SNAKEN_ERROR_NONE) {
+        goto failed;
+    }
+
+    // Only mark the segment as valid once it is fully populated, so that clients never see it half-initialized.
+    header->version = SNAKEN_SHM_VERSION;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    header->magic = SNAKEN_SHM_MAGIC;
+    snaken_shm_publish(&(header->results_seq), &(header->results_waiters), 1);
+
+    return SNAKEN_ERROR_NONE;
+
+failed:
+    // Remove the segment as well: it is never marked valid, so later servers could not tell it was abandoned.
+    for (snaken_world_size_t n = 0; n < worlds_initialized; n++) {
+        snaken2d_destroy((*server)->worlds[n]);
+    }
+    free((*server)->worlds);
+    free((*server)->eaten_apples);
+    munmap(segment, layout_header.size);
+    shm_unlink(name);
+    free(*server);
+
+    return error;
+}
+
+snaken_error_code_t snaken_shm_server_destroy(snaken_shm_server_t* server) {
+    for (snaken_world_size_t n = 0; n < server->header->worlds_count; n++) {
+        snaken2d_destroy(server->worlds[n]);
+    }
+    free(server->worlds);
+    free(server->eaten_apples);
+
+    munmap(server->header, server->header->size);
+    shm_unlink(server->name);
+    free(server);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_server_run(snaken_shm_server_t* server) {
+    snaken_shm_header_t* header = server->header;
+
+    for (uint32_t seq = 1;; seq++) {
+        snaken_shm_wait(header, &(header->requests_seq), &(header->requests_waiters), seq - 1, server->spin_count);
+        if (__atomic_load_n(&(header->shutdown), __ATOMIC_SEQ_CST)) break;
+
+        snaken_error_code_t error = snaken_shm_server_step(server, seq);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+
+        snaken_shm_publish(&(header->results_seq), &(header->results_waiters), seq + 1);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_server_stop(snaken_shm_server_t* server) {
+    __atomic_store_n(&(server->header->shutdown), 1, __ATOMIC_SEQ_CST);
+    snaken_shm_wake(&(server->header->requests_seq));
+    snaken_shm_wake(&(server->header->results_seq));
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Client functions.
+// ##########################################
+
+snaken_error_code_t snaken_shm_client_connect(snaken_shm_client_t** client, const char* name) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+
+    // Map the header first to learn the segment size.
+    struct stat segment_stat;
+    if (fstat(fd, &segment_stat) != 0 || (size_t) segment_stat.st_size < sizeof(snaken_shm_header_t)) {
+        close(fd);
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+    void* segment = mmap(NULL, segment_stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+
+    snaken_shm_header_t* header = (snaken_shm_header_t*) segment;
+    if (header->magic != SNAKEN_SHM_MAGIC || header->version != SNAKEN_SHM_VERSION || header->size != (uint64_t) segment_stat.st_size) {
+        munmap(segment, segment_stat.st_size);
+        return SNAKEN_ERROR_FAILED_SHM;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    (*client) = (snaken_shm_client_t*) malloc(sizeof(snaken_shm_client_t));
+    if ((*client) == NULL) {
+        munmap(segment, segment_stat.st_size);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Pick up from wherever previous clients left.
+    (*client)->header = header;
+    (*client)->sent_seq = __atomic_load_n(&(header->requests_seq), __ATOMIC_SEQ_CST);
+    (*client)->recv_seq = (*client)->sent_seq;
+    (*client)->spin_count = snaken_shm_spin_count();
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_client_disconnect(snaken_shm_client_t* client) {
+    munmap(client->header, client->header->size);
+    free(client);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_client_send(snaken_shm_client_t* client, uint8_t* actions) {
+    snaken_shm_header_t* header = client->header;
+    uint32_t seq = client->sent_seq + 1;
+
+    // The result frame of the new step must not overwrite any result not received yet, nor the last received one.
+    if (seq - client->recv_seq + 1 >= (uint32_t) header->depth) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    memcpy(snaken_shm_frame(header, header->actions_offset, header->actions_frame_size, seq), actions, header->worlds_count * sizeof(uint8_t));
+
+    client->sent_seq = seq;
+    snaken_shm_publish(&(header->requests_seq), &(header->requests_waiters), seq);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_client_recv(
+    snaken_shm_client_t* client,
+    snaken_obs_t** views,
+    snaken_obs_t** features,
+    float** rewards,
+    uint8_t** dones
+) {
+    snaken_shm_header_t* header = client->header;
+    uint32_t seq = client->recv_seq;
+
+    // Results of step [seq] are available once [seq + 1] steps were published.
+    while ((int32_t) (__atomic_load_n(&(header->results_seq), __ATOMIC_SEQ_CST) - seq) <= 0) {
+        if (__atomic_load_n(&(header->shutdown), __ATOMIC_SEQ_CST)) {
+            return SNAKEN_ERROR_FAILED_SHM;
+        }
+        snaken_shm_wait(header, &(header->results_seq), &(header->results_waiters), seq, client->spin_count);
+    }
+
+    (*views) = (snaken_obs_t*) snaken_shm_frame(header, header->views_offset, header->views_frame_size, seq);
+    (*features) = (snaken_obs_t*) snaken_shm_frame(header, header->features_offset, header->features_frame_size, seq);
+    (*rewards) = (float*) snaken_shm_frame(header, header->rewards_offset, header->rewards_frame_size, seq);
+    (*dones) = (uint8_t*) snaken_shm_frame(header, header->dones_offset, header->dones_frame_size, seq);
+
+    client->recv_seq = seq + 1;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_shm_client_shutdown(snaken_shm_client_t* client) {
+    __atomic_store_n(&(client->header->shutdown), 1, __ATOMIC_SEQ_CST);
+    snaken_shm_wake(&(client->header->requests_seq));
+    snaken_shm_wake(&(client->header->results_seq));
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -0,0 +1,246 @@
+/*
+*****************************************************************
+shm.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __SNAKEN_SHM__
+#define __SNAKEN_SHM__
+
+#include "snaken.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Identifies snaken shared memory segments ("SNKN").
+#define SNAKEN_SHM_MAGIC 0x534E4B4Eu
+
+// Version of the shared memory layout, bumped on any incompatible change.
+#define SNAKEN_SHM_VERSION 0x02u
+
+// Number of step frames in the shared rings, which bounds the number of steps a client can have in flight.
+#define SNAKEN_DEFAULT_SHM_DEPTH 0x04u
+
+// Number of polls before a waiting side goes to sleep, so that a busy loop never performs syscalls.
+#define SNAKEN_SHM_SPIN_COUNT 0x8000u
+
+// Maximum length of a shared memory segment name, terminator included.
+#define SNAKEN_SHM_NAME_LENGTH 0x40u
+
+// Aligns a header field, spelled as both C and C++ understand it.
+#ifdef __cplusplus
+#define SNAKEN_SHM_ALIGNAS(alignment) alignas(alignment)
+#else
+#define SNAKEN_SHM_ALIGNAS(alignment) _Alignas(alignment)
+#endif
+
+// Header at the start of a shared memory segment.
+// Every step is a pair of frames in two rings: the client writes actions in the request frame of the step, the server
+// steps every world and writes observations, rewards and done flags in the result frame of the step.
+// Frame [i] of a ring lives at [offset + (i % depth) * frame_size].
+typedef struct {
+    // ################
+    // Segment description, immutable once the server started.
+    // ################
+
+    uint32_t magic;
+    uint32_t version;
+
+    // Size of the whole segment in bytes.
+    uint64_t size;
+
+    // Process id of the server owning the segment, so that servers only replace segments whose owner is gone.
+    int32_t owner_pid;
+
+    // Number of worlds hosted by the server.
+    snaken_world_size_t worlds_count;
+
+    // Size of every world.
+    snaken_world_size_t world_width;
+    snaken_world_size_t world_height;
+
+    // Radius of the observed views.
+    snaken_world_size_t view_radius;
+
+    // Number of frames in each ring.
+    snaken_world_size_t depth;
+
+    // Layout of observations in every result frame.
+    snaken_obs_layout_t layout;
+
+    // Offset from the segment start and size of every frame, in bytes.
+    uint64_t actions_offset;
+    uint64_t actions_frame_size;
+    uint64_t views_offset;
+    uint64_t views_frame_size;
+    uint64_t features_offset;
+    uint64_t features_frame_size;
+    uint64_t rewards_offset;
+    uint64_t rewards_frame_size;
+    uint64_t dones_offset;
+    uint64_t dones_frame_size;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Synchronization, each counter on its own cache line to avoid false sharing.
+    // Plain counters only ever accessed through atomic builtins, so that the header stays usable from C++.
+    // ################
+
+    // Number of steps requested by the client. Step 0 is the initial observation, so the first request is step 1.
+    SNAKEN_SHM_ALIGNAS(SNAKEN_OBS_ALIGNMENT) uint32_t requests_seq;
+
+    // Number of sleepers waiting for [requests_seq] to change.
+    uint32_t requests_waiters;
+
+    // Number of steps whose results were published by the server.
+    SNAKEN_SHM_ALIGNAS(SNAKEN_OBS_ALIGNMENT) uint32_t results_seq;
+
+    // Number of sleepers waiting for [results_seq] to change.
+    uint32_t results_waiters;
+
+    // Whether the server was asked to stop.
+    SNAKEN_SHM_ALIGNAS(SNAKEN_OBS_ALIGNMENT) uint32_t shutdown;
+
+    // ################
+    // ################
+} snaken_shm_header_t;
+
+// Server side of a shared memory segment: the owner of the segment and of the hosted worlds.
+typedef struct {
+    // Name of the segment.
+    char name[SNAKEN_SHM_NAME_LENGTH];
+
+    // Mapped segment.
+    snaken_shm_header_t* header;
+
+    // Hosted worlds.
+    snaken2d_t** worlds;
+
+    // Eaten apples count of every world after the last step, used to compute rewards.
+    snaken_world_size_t* eaten_apples;
+
+    // Number of polls before sleeping while waiting for requests.
+    uint32_t spin_count;
+} snaken_shm_server_t;
+
+// Client side of a shared memory segment.
+typedef struct {
+    // Mapped segment.
+    snaken_shm_header_t* header;
+
+    // Number of the last requested step.
+    uint32_t sent_seq;
+
+    // Number of the next step to receive results of.
+    uint32_t recv_seq;
+
+    // Number of polls before sleeping while waiting for results.
+    uint32_t spin_count;
+} snaken_shm_client_t;
+
+
+// ##########################################
+// Server functions.
+// ##########################################
+
+/// @brief Creates a shared memory segment hosting [worlds_count] default worlds and publishes their initial observations.
+/// An existing segment with the same name is only replaced if the server owning it is not running anymore.
+/// @param server The server to initialize.
+/// @param name The name of the segment, starting with '/' as required by shm_open.
+/// @param worlds_count The number of worlds to host.
+/// @param world_width The width of every world.
+/// @param world_height The height of every world.
+/// @param view_radius The radius of the observed views.
+/// @param depth The number of frames in each ring, at least 2.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none,
+/// [SNAKEN_ERROR_FAILED_SHM] if the segment could not be created or is owned by a running server.
+snaken_error_code_t snaken_shm_server_init(
+    snaken_shm_server_t** server,
+    const char* name,
+    snaken_world_size_t worlds_count,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t view_radius,
+    snaken_world_size_t depth
+);
+
+/// @brief Unmaps and removes the shared memory segment and destroys the hosted worlds.
+/// @param server The server to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_shm_server_destroy(snaken_shm_server_t* server);
+
+/// @brief Serves step requests until the server is stopped, either by [snaken_shm_server_stop] or by a client.
+/// Every step applies the requested actions, ticks all worlds in parallel and publishes their observations.
+/// Worlds whose snake died report a done flag with a -1 penalty and are reset in place, so their observation is the first of the new episode.
+/// @param server The server to run.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_shm_server_run(snaken_shm_server_t* server);
+
+/// @brief Asks the provided server to stop. Safe to call from signal handlers.
+/// @param server The server to stop.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_shm_server_stop(snaken_shm_server_t* server);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Client functions.
+// ##########################################
+
+/// @brief Connects to the shared memory segment of a running server.
+/// @param client The client to initialize.
+/// @param name The name of the segment.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_FAILED_SHM] if the segment does not exist or was created by an incompatible version.
+snaken_error_code_t snaken_shm_client_connect(snaken_shm_client_t** client, const char* name);
+
+/// @brief Disconnects from the shared memory segment, leaving the server running.
+/// @param client The client to disconnect.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_shm_client_disconnect(snaken_shm_client_t* client);
+
+/// @brief Requests a step with the provided actions, without waiting for it to complete.
+/// @param client The client to request the step from.
+/// @param actions The action of every world, see [snaken_action_t].
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if the rings are full, in which case results must be received first.
+snaken_error_code_t snaken_shm_client_send(snaken_shm_client_t* client, uint8_t* actions);
+
+/// @brief Waits for the results of the oldest step not received yet. The first call returns the initial observations.
+/// The returned arrays point into the shared memory segment and stay valid until the next call.
+/// @param client The client to receive results with.
+/// @param views The observed views, laid out as described by the header layout.
+/// @param features The observed features, laid out as described by the header layout.
+/// @param rewards The reward of every world.
+/// @param dones The done flag of every world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_FAILED_SHM] if the server stopped.
+snaken_error_code_t snaken_shm_client_recv(
+    snaken_shm_client_t* client,
+    snaken_obs_t** views,
+    snaken_obs_t** features,
+    float** rewards,
+    uint8_t** dones
+);
+
+/// @brief Asks the server to stop.
+/// @param client The client to ask from.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_shm_client_shutdown(snaken_shm_client_t* client);
+
+// ##########################################
+// ##########################################
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
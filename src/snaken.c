@@ -1,5 +1,524 @@
 #include "snaken.h"
 
+// Distance value of cells from which no apple can be reached, kept as large as possible to simplify comparisons.
+#define SNAKEN_DIST_INF INT32_MAX
+
+// Parent value of cells with no parent in the distance field.
+#define SNAKEN_DIST_NO_PARENT 0xFFu
+
+// ##########################################
+// Apple distance field functions.
+// ##########################################
+
+/// @brief Computes the world-space unit vector of the provided direction.
+/// @param direction The direction to compute the vector of, wrapped to the valid directions.
+/// @param x The x component of the vector.
+/// @param y The y component of the vector.
+static void snaken_dir_vector(
+    snaken_world_size_t direction,
+    snaken_world_size_t* x,
+    snaken_world_size_t* y
+) {
+    switch (WRAP(direction, 4)) {
+        case SNAKEN_UP:
+            (*x) = 0;
+            (*y) = -1;
+            break;
+        case SNAKEN_LEFT:
+            (*x) = -1;
+            (*y) = 0;
+            break;
+        case SNAKEN_DOWN:
+            (*x) = 0;
+            (*y) = 1;
+            break;
+        case SNAKEN_RIGHT:
+        default:
+            (*x) = 1;
+            (*y) = 0;
+            break;
+    }
+}
+
+/// @brief Computes the location of the neighbor of [location] along the provided direction, wrapping around the world.
+/// @param snaken The snaken the location belongs to.
+/// @param location The location to compute the neighbor of.
+/// @param direction The direction of the neighbor.
+/// @return The neighbor location.
+static snaken_world_size_t snaken2d_neighbor(
+    snaken2d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t direction
+) {
+    snaken_world_size_t x;
+    snaken_world_size_t y;
+    snaken_dir_vector(direction, &x, &y);
+
+    return IDX2D(
+        WRAP(location % snaken->world_width + x, snaken->world_width),
+        WRAP(location / snaken->world_width + y, snaken->world_height),
+        snaken->world_width
+    );
+}
+
+/// @brief Pushes the provided location to the distance update queue, unless already there.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location to push.
+/// @param queue_end The end of the circular queue, updated accordingly.
+static void snaken2d_dist_enqueue(
+    snaken2d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t* queue_end
+) {
+    if (snaken->apple_dist_queued[location]) return;
+
+    // Every location is in the queue at most once, so one slot more than the world size keeps a full queue distinct from an empty one.
+    snaken->apple_dist_queue[*queue_end] = location;
+    snaken->apple_dist_queued[location] = SNAKEN_TRUE;
+    (*queue_end) = ((*queue_end) + 1) % (snaken->world_width * snaken->world_height + 1);
+}
+
+/// @brief Propagates distance decreases from the locations in the update queue, until no distance can decrease anymore.
+/// @param snaken The snaken to update the distance field of.
+/// @param queue_end The end of the circular queue, which always starts at 0.
+static void snaken2d_dist_propagate(
+    snaken2d_t* snaken,
+    snaken_world_size_t queue_end
+) {
+    snaken_world_size_t queue_size = snaken->world_width * snaken->world_height + 1;
+
+    for (snaken_world_size_t queue_start = 0; queue_start != queue_end; queue_start = (queue_start + 1) % queue_size) {
+        snaken_world_size_t location = snaken->apple_dist_queue[queue_start];
+        snaken->apple_dist_queued[location] = SNAKEN_FALSE;
+
+        for (snaken_world_size_t d = 0; d < 4; d++) {
+            snaken_world_size_t neighbor = snaken2d_neighbor(snaken, location, d);
+
+            if (snaken->apple_dist_blocks[neighbor] > 0 || snaken->apple_dist[location] + 1 >= snaken->apple_dist[neighbor]) continue;
+
+            // The neighbor is reached from the opposite direction.
+            snaken->apple_dist[neighbor] = snaken->apple_dist[location] + 1;
+            snaken->apple_dist_parents[neighbor] = (d + 2) % 4;
+            snaken2d_dist_enqueue(snaken, neighbor, &queue_end);
+        }
+    }
+}
+
+/// @brief Computes the distance of the provided location from its nearest neighbor, and pushes it to the update queue if any is reachable.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location to reseed.
+/// @param queue_end The end of the circular queue, updated accordingly.
+static void snaken2d_dist_reseed(
+    snaken2d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t* queue_end
+) {
+    if (snaken->apple_dist_blocks[location] > 0) return;
+
+    if (snaken->apple_dist_apples[location] > 0) {
+        snaken->apple_dist[location] = 0;
+        snaken->apple_dist_parents[location] = SNAKEN_DIST_NO_PARENT;
+    } else {
+        for (snaken_world_size_t d = 0; d < 4; d++) {
+            snaken_world_size_t neighbor = snaken2d_neighbor(snaken, location, d);
+
+            // Blocked cells are always at infinite distance.
+            if (snaken->apple_dist[neighbor] == SNAKEN_DIST_INF || snaken->apple_dist[neighbor] + 1 >= snaken->apple_dist[location]) continue;
+
+            snaken->apple_dist[location] = snaken->apple_dist[neighbor] + 1;
+            snaken->apple_dist_parents[location] = d;
+        }
+    }
+
+    if (snaken->apple_dist[location] != SNAKEN_DIST_INF) snaken2d_dist_enqueue(snaken, location, queue_end);
+}
+
+/// @brief Invalidates the distance of the provided location and of all locations whose distance was propagated through it,
+/// then recomputes them from their still valid neighbors.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location whose distance increased.
+static void snaken2d_dist_raise(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    snaken_world_size_t stale_length = 1;
+    snaken->apple_dist_stale[0] = location;
+    snaken->apple_dist[location] = SNAKEN_DIST_INF;
+    snaken->apple_dist_parents[location] = SNAKEN_DIST_NO_PARENT;
+
+    // Walk the propagation tree below the location: a neighbor is a child if its parent lies in the opposite direction.
+    for (snaken_world_size_t i = 0; i < stale_length; i++) {
+        for (snaken_world_size_t d = 0; d < 4; d++) {
+            snaken_world_size_t neighbor = snaken2d_neighbor(snaken, snaken->apple_dist_stale[i], d);
+
+            if (snaken->apple_dist[neighbor] == SNAKEN_DIST_INF || snaken->apple_dist_parents[neighbor] != (d + 2) % 4) continue;
+
+            snaken->apple_dist[neighbor] = SNAKEN_DIST_INF;
+            snaken->apple_dist_parents[neighbor] = SNAKEN_DIST_NO_PARENT;
+            snaken->apple_dist_stale[stale_length++] = neighbor;
+        }
+    }
+
+    // Distances outside the invalidated tree are still exact, so they can seed the new ones.
+    snaken_world_size_t queue_end = 0;
+    for (snaken_world_size_t i = 0; i < stale_length; i++) {
+        snaken2d_dist_reseed(snaken, snaken->apple_dist_stale[i], &queue_end);
+    }
+    snaken2d_dist_propagate(snaken, queue_end);
+}
+
+/// @brief Marks the provided location as blocked by one more element.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location to block.
+static void snaken2d_dist_block(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->apple_dist == NULL) return;
+
+    snaken->apple_dist_blocks[location]++;
+    if (snaken->apple_dist_blocks[location] == 1) snaken2d_dist_raise(snaken, location);
+}
+
+/// @brief Marks the provided location as blocked by one less element.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location to unblock.
+static void snaken2d_dist_unblock(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->apple_dist == NULL) return;
+
+    snaken->apple_dist_blocks[location]--;
+    if (snaken->apple_dist_blocks[location] > 0) return;
+
+    snaken_world_size_t queue_end = 0;
+    snaken2d_dist_reseed(snaken, location, &queue_end);
+    snaken2d_dist_propagate(snaken, queue_end);
+}
+
+/// @brief Marks the provided location as blocked by one more body section, if the snake body blocks paths at all.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location of the body section.
+static void snaken2d_dist_block_body(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->self_intersects == SNAKEN_FALSE) snaken2d_dist_block(snaken, location);
+}
+
+/// @brief Marks the provided location as blocked by one less body section, if the snake body blocks paths at all.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location of the body section.
+static void snaken2d_dist_unblock_body(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->self_intersects == SNAKEN_FALSE) snaken2d_dist_unblock(snaken, location);
+}
+
+/// @brief Adds an apple at the provided location to the distance field.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location of the apple.
+static void snaken2d_dist_add_apple(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->apple_dist == NULL) return;
+
+    snaken->apple_dist_apples[location]++;
+    if (snaken->apple_dist_apples[location] > 1 || snaken->apple_dist_blocks[location] > 0) return;
+
+    snaken_world_size_t queue_end = 0;
+    snaken->apple_dist[location] = 0;
+    snaken->apple_dist_parents[location] = SNAKEN_DIST_NO_PARENT;
+    snaken2d_dist_enqueue(snaken, location, &queue_end);
+    snaken2d_dist_propagate(snaken, queue_end);
+}
+
+/// @brief Removes an apple at the provided location from the distance field.
+/// @param snaken The snaken to update the distance field of.
+/// @param location The location of the apple.
+static void snaken2d_dist_remove_apple(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken->apple_dist == NULL) return;
+
+    snaken->apple_dist_apples[location]--;
+    if (snaken->apple_dist_apples[location] > 0 || snaken->apple_dist_blocks[location] > 0) return;
+
+    snaken2d_dist_raise(snaken, location);
+}
+
+/// @brief Frees the distance field, disabling distance tracking.
+/// @param snaken The snaken to free the distance field of.
+static void snaken2d_dist_free(
+    snaken2d_t* snaken
+) {
+    free(snaken->apple_dist);
+    free(snaken->apple_dist_parents);
+    free(snaken->apple_dist_blocks);
+    free(snaken->apple_dist_apples);
+    free(snaken->apple_dist_stale);
+    free(snaken->apple_dist_queue);
+    free(snaken->apple_dist_queued);
+    snaken->apple_dist = NULL;
+    snaken->apple_dist_parents = NULL;
+    snaken->apple_dist_blocks = NULL;
+    snaken->apple_dist_apples = NULL;
+    snaken->apple_dist_stale = NULL;
+    snaken->apple_dist_queue = NULL;
+    snaken->apple_dist_queued = NULL;
+}
+
+/// @brief Recomputes the whole distance field from scratch.
+/// @param snaken The snaken to rebuild the distance field of.
+static void snaken2d_dist_rebuild(
+    snaken2d_t* snaken
+) {
+    if (snaken->apple_dist == NULL) return;
+
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        snaken->apple_dist[i] = SNAKEN_DIST_INF;
+        snaken->apple_dist_parents[i] = SNAKEN_DIST_NO_PARENT;
+        snaken->apple_dist_blocks[i] = 0;
+        snaken->apple_dist_apples[i] = 0;
+        snaken->apple_dist_queued[i] = SNAKEN_FALSE;
+    }
+
+    // Count blocking elements.
+    for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
+        snaken->apple_dist_blocks[snaken->walls[i]]++;
+    }
+    if (snaken->snake_alive && snaken->self_intersects == SNAKEN_FALSE) {
+        for (snaken_world_size_t i = 1; i < snaken->snake_length; i++) {
+            snaken->apple_dist_blocks[snaken->snake_body[i]]++;
+        }
+    }
+
+    // Run a single breadth first search from all reachable apples at once.
+    snaken_world_size_t queue_end = 0;
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken_world_size_t location = snaken->apples[i];
+        snaken->apple_dist_apples[location]++;
+
+        if (snaken->apple_dist_blocks[location] > 0) continue;
+
+        snaken->apple_dist[location] = 0;
+        snaken2d_dist_enqueue(snaken, location, &queue_end);
+    }
+    snaken2d_dist_propagate(snaken, queue_end);
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Wall storage functions.
+// ##########################################
+
+/// @brief Checks whether the provided location holds a wall.
+/// @param snaken The snaken to look the wall up in.
+/// @param location The location to check.
+/// @return Whether the location holds a wall.
+static snaken_bool_t snaken2d_is_wall(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    return snaken->walls_index[location] != SNAKEN_NO_WALL ? SNAKEN_TRUE : SNAKEN_FALSE;
+}
+
+/// @brief Stores a wall at the provided location, unless one is already there, leaving the distance field untouched.
+/// @param snaken The snaken to store the wall in.
+/// @param location The location of the wall.
+/// @return Whether a new wall was stored.
+static snaken_bool_t snaken2d_store_wall(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken2d_is_wall(snaken, location)) return SNAKEN_FALSE;
+
+    snaken->walls_index[location] = snaken->walls_length;
+    snaken->walls[snaken->walls_length] = location;
+    snaken->walls_length++;
+
+    return SNAKEN_TRUE;
+}
+
+/// @brief Stores a wall at the provided location, unless one is already there.
+/// @param snaken The snaken to store the wall in.
+/// @param location The location of the wall.
+static void snaken2d_insert_wall(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken2d_store_wall(snaken, location)) snaken2d_dist_block(snaken, location);
+}
+
+/// @brief Removes all walls by only visiting the cells they occupy, leaving the distance field untouched.
+/// @param snaken The snaken to remove the walls from.
+static void snaken2d_reset_walls(
+    snaken2d_t* snaken
+) {
+    for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
+        snaken->walls_index[snaken->walls[i]] = SNAKEN_NO_WALL;
+    }
+    snaken->walls_length = 0;
+}
+
+/// @brief Removes the wall at the provided location, if any, leaving the distance field untouched.
+/// @param snaken The snaken to remove the wall from.
+/// @param location The location of the wall.
+/// @return Whether a wall was removed.
+static snaken_bool_t snaken2d_discard_wall(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    snaken_world_size_t index = snaken->walls_index[location];
+    if (index == SNAKEN_NO_WALL) return SNAKEN_FALSE;
+
+    snaken->walls_length--;
+    snaken_world_size_t last = snaken->walls[snaken->walls_length];
+    snaken->walls[index] = last;
+    snaken->walls_index[last] = index;
+    snaken->walls_index[location] = SNAKEN_NO_WALL;
+
+    return SNAKEN_TRUE;
+}
+
+/// @brief Removes the wall at the provided location, if any, by moving the last wall in its place.
+/// @param snaken The snaken to remove the wall from.
+/// @param location The location of the wall.
+static void snaken2d_erase_wall(
+    snaken2d_t* snaken,
+    snaken_world_size_t location
+) {
+    if (snaken2d_discard_wall(snaken, location)) snaken2d_dist_unblock(snaken, location);
+}
+
+/// @brief Gives the provided snaken its own copy of the walls of its shared map, if any, so that they can be modified.
+/// @param snaken The snaken to give the walls to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_own_walls(
+    snaken2d_t* snaken
+) {
+    if (snaken->map == NULL) return SNAKEN_ERROR_NONE;
+
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+    snaken_world_size_t* walls = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    snaken_world_size_t* walls_index = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    if (walls == NULL || walls_index == NULL) {
+        free(walls);
+        free(walls_index);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    memcpy(walls, snaken->map->walls, snaken->map->walls_length * sizeof(snaken_world_size_t));
+    memcpy(walls_index, snaken->map->walls_index, world_size * sizeof(snaken_world_size_t));
+    snaken->walls = walls;
+    snaken->walls_index = walls_index;
+
+    snaken2d_map_release(snaken->map);
+    snaken->map = NULL;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Checks that the provided rectangle lies inside the world.
+/// @param snaken The snaken the rectangle is meant for.
+/// @param x The x location of the top left corner of the rectangle.
+/// @param y The y location of the top left corner of the rectangle.
+/// @param width The width of the rectangle.
+/// @param height The height of the rectangle.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_check_rect(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+) {
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x + width > snaken->world_width || y + height > snaken->world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Checks that all provided walls lie inside the world.
+/// @param snaken The snaken the walls are meant for.
+/// @param walls_length The length of the walls array.
+/// @param walls The array of walls.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_check_walls(
+    snaken2d_t* snaken,
+    snaken_world_size_t walls_length,
+    snaken_world_size_t* walls
+) {
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        if (walls[i] < 0 || walls[i] >= world_size) {
+            return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Computes a random location free from walls, from the snake head and from the first [apples_count] apples.
+/// Keeping apples off the head and off each other makes the snake eat at most one apple per move.
+/// Only walls are avoided if there is no room left for the rest.
+/// @param snaken The snaken to compute the location in.
+/// @param apples_count The number of apples, from the first one, to keep the location free from.
+/// @return The computed location, [SNAKEN_NO_CELL] if walls cover the whole world.
+static snaken_world_size_t snaken2d_random_free_location(snaken2d_t* snaken, snaken_world_size_t apples_count) {
+    // Setup variables for location generation.
+    snaken_world_size_t apple_x;
+    snaken_world_size_t apple_y;
+    snaken_world_size_t apple_location;
+    snaken_bool_t location_free;
+
+    // A world made of walls only leaves no room for apples.
+    snaken_world_size_t free_cells = snaken->world_width * snaken->world_height - snaken->walls_length;
+    if (free_cells <= 0) return SNAKEN_NO_CELL;
+
+    // Worlds too crowded to keep apples apart only keep them off walls, so that a location can always be found.
+    snaken_bool_t crowded = free_cells <= apples_count + 1;
+
+    do {
+        location_free = SNAKEN_TRUE;
+
+        // Compute a random location for the apple.
+        apple_x = snaken_rng_range(&(snaken->rng), snaken->world_width);
+        apple_y = snaken_rng_range(&(snaken->rng), snaken->world_height);
+        apple_location = IDX2D(apple_x, apple_y, snaken->world_width);
+
+        // Make sure the picked location is free from walls.
+        if (snaken2d_is_wall(snaken, apple_location)) location_free = SNAKEN_FALSE;
+
+        if (!location_free || crowded) continue;
+
+        // Make sure the picked location is free from the snake head, if any is left.
+        if (snaken->snake_body != NULL && snaken->snake_body[0] == apple_location) location_free = SNAKEN_FALSE;
+
+        // Make sure the picked location is free from other apples.
+        for (snaken_world_size_t i = 0; location_free && i < apples_count; i++) {
+            if (snaken->apples[i] == apple_location) location_free = SNAKEN_FALSE;
+        }
+    } while(!location_free);
+
+    return apple_location;
+}
+
+// ##########################################
+// ##########################################
+
+
 // ##########################################
 // Initialization functions.
 // ##########################################
@@ -19,12 +538,33 @@ snaken_error_code_t snaken2d_init(
     (*snaken)->world_width = world_width;
     (*snaken)->world_height = world_height;
 
-    // Allocate walls.
+    // Allocate walls, with room for a wall on every cell.
+    snaken_world_size_t world_size = world_width * world_height;
     (*snaken)->walls_length = 0;
-    (*snaken)->walls = (snaken_world_size_t*) malloc((*snaken)->walls_length * sizeof(snaken_world_size_t));
-    if ((*snaken)->walls == NULL) {
+    (*snaken)->walls = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    (*snaken)->walls_index = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    if ((*snaken)->walls == NULL || (*snaken)->walls_index == NULL) {
         return SNAKEN_ERROR_FAILED_ALLOC;
     }
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        (*snaken)->walls_index[i] = SNAKEN_NO_WALL;
+    }
+    (*snaken)->map = NULL;
+
+    // Distance tracking is disabled by default.
+    (*snaken)->apple_dist = NULL;
+    (*snaken)->apple_dist_parents = NULL;
+    (*snaken)->apple_dist_blocks = NULL;
+    (*snaken)->apple_dist_apples = NULL;
+    (*snaken)->apple_dist_stale = NULL;
+    (*snaken)->apple_dist_queue = NULL;
+    (*snaken)->apple_dist_queued = NULL;
+
+    // Events are disabled by default.
+    (*snaken)->events = NULL;
+
+    // Seed the world generator from the global one, so that srand() still drives worlds unless they are explicitly seeded.
+    (*snaken)->rng = ((uint64_t) rand() << 32) ^ (uint64_t) rand();
 
     // Allocate apples.
     (*snaken)->apples_length = SNAKEN_DEFAULT_APPLES_LENGTH;
@@ -34,11 +574,6 @@ snaken_error_code_t snaken2d_init(
     }
     (*snaken)->eaten_apples_count = 0;
 
-    // Populate apples.
-    for (snaken_world_size_t i = 0; i < (*snaken)->apples_length; i++) {
-        snaken2d_spawn_apple(*snaken, i);
-    }
-
     // Allocate snake body.
     (*snaken)->snake_length = SNAKEN_STARTING_SNAKE_LENGTH;
     // The head starts out.
@@ -56,6 +591,11 @@ snaken_error_code_t snaken2d_init(
         (*snaken)->snake_body[i] = (*snaken)->snake_body[0];
     }
 
+    // Populate apples once the snake is in place, so that they stay off its head.
+    for (snaken_world_size_t i = 0; i < (*snaken)->apples_length; i++) {
+        (*snaken)->apples[i] = snaken2d_random_free_location(*snaken, i);
+    }
+
     (*snaken)->snake_speed = SNAKEN_DEFAULT_SNAKE_SPEED;
     (*snaken)->snake_speed_step = 0;
     (*snaken)->snake_stamina = SNAKEN_DEFAULT_SNAKE_STAMINA;
@@ -71,11 +611,17 @@ snaken_error_code_t snaken2d_init(
 snaken_error_code_t snaken2d_destroy(
     snaken2d_t* snaken
 ) {
-    // Only free snake body if the snake is still alive, otherwise it will already be freed.
-    if (snaken->snake_alive == SNAKEN_TRUE) free(snaken->snake_body);
+    // The snake body is NULL if the snake starved, so it can be freed regardless of how the snake died.
+    free(snaken->snake_body);
 
-    free(snaken->walls);
+    if (snaken->map != NULL) {
+        snaken2d_map_release(snaken->map);
+    } else {
+        free(snaken->walls);
+        free(snaken->walls_index);
+    }
     free(snaken->apples);
+    snaken2d_dist_free(snaken);
     free(snaken);
 
     return SNAKEN_ERROR_NONE;
@@ -88,24 +634,95 @@ snaken_error_code_t snaken2d_destroy(
 // Execution functions.
 // ##########################################
 
-snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
+/// @brief Finds the apple lying on the provided cell.
+/// @param snaken The snaken to look for apples in.
+/// @param cell The cell to look at.
+/// @return The index of the first apple lying on the cell, [SNAKEN_NO_CELL] if none.
+static snaken_world_size_t snaken2d_find_apple(snaken2d_t* snaken, snaken_world_size_t cell) {
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        if (snaken->apples[i] == cell) return i;
+    }
+
+    return SNAKEN_NO_CELL;
+}
+
+/// @brief Lets the snake eat the apple at the provided index, growing the snake and spawning a new apple.
+/// @param snaken The snaken the snake lives in.
+/// @param index The index of the apple to eat.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_eat_apple_at(snaken2d_t* snaken, snaken_world_size_t index) {
+    // Increase the number of eaten apples.
+    snaken->eaten_apples_count++;
+
+    // Eat the apple and spawn a new one.
+    snaken2d_spawn_apple(snaken, index);
+
+    // Increase the snake length.
+    snaken->snake_length++;
+    snaken->snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, snaken->snake_length * sizeof(snaken_world_size_t));
+    if (snaken->snake_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Place the new body piece exactly on the existing tail.
+    snaken->snake_body[snaken->snake_length - 1] = snaken->snake_body[snaken->snake_length - 2];
+    snaken2d_dist_block_body(snaken, snaken->snake_body[snaken->snake_length - 1]);
+
+    // Reset stamina step.
+    snaken->snake_stamina_step = 0;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Records the provided event to the provided ring, dropping it if the ring is full.
+/// @param ring The ring to record the event to.
+/// @param event The event to record.
+static void snaken_event_ring_push(snaken_event_ring_t* ring, snaken_event_t* event) {
+    uint32_t write_count = __atomic_load_n(&(ring->write_count), __ATOMIC_RELAXED);
+
+    // Never overwrite unread events, since the consumer may be reading them right now.
+    if (write_count - __atomic_load_n(&(ring->read_count), __ATOMIC_ACQUIRE) >= ring->capacity) {
+        __atomic_fetch_add(&(ring->dropped_count), 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    ring->events[write_count & (ring->capacity - 1)] = *event;
+    __atomic_store_n(&(ring->write_count), write_count + 1, __ATOMIC_RELEASE);
+}
+
+/// @brief Performs a single run cycle in the provided snaken, which must hold a live snake.
+/// @param snaken The snaken to run the loop in.
+/// @param event The changes made by the cycle.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_step(snaken2d_t* snaken, snaken_event_t* event) {
     snaken_error_code_t error = SNAKEN_ERROR_NONE;
 
     // 1: Move the snake along its facing direction.
+    // The speed buildup only ever gets back to 0 when the snake moves.
+    snaken_world_size_t tail = snaken->snake_body[snaken->snake_length - 1];
     error = snaken2d_move_snake(snaken);
     if (error != SNAKEN_ERROR_NONE) {
         return error;
     }
+    if (snaken->snake_speed_step == 0) {
+        event->flags |= SNAKEN_EVENT_MOVED;
+        event->head = snaken->snake_body[0];
+        event->tail = tail;
+    }
 
     // 2: Let the snake eat any apple in its way.
-    snaken_bool_t apple_found = SNAKEN_FALSE;
-    error = snaken2d_eat_apple(snaken, &apple_found);
-    if (error != SNAKEN_ERROR_NONE) {
-        return error;
-    }
+    snaken_world_size_t apple_index = snaken2d_find_apple(snaken, snaken->snake_body[0]);
 
     // If any apple was found, then no wall can, so just end here.
-    if (apple_found) {
+    if (apple_index != SNAKEN_NO_CELL) {
+        event->apple_from = snaken->apples[apple_index];
+        error = snaken2d_eat_apple_at(snaken, apple_index);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+        event->flags |= SNAKEN_EVENT_GREW;
+        event->apple_to = snaken->apples[apple_index];
+
         return SNAKEN_ERROR_NONE;
     }
 
@@ -117,6 +734,8 @@ snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
     }
 
     if (wall_found) {
+        event->flags |= SNAKEN_EVENT_DIED;
+        event->death_cause = SNAKEN_DEATH_WALL;
         return SNAKEN_ERROR_NONE;
     }
 
@@ -127,6 +746,11 @@ snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
         return error;
     }
 
+    if (body_found) {
+        event->flags |= SNAKEN_EVENT_DIED;
+        event->death_cause = SNAKEN_DEATH_BODY;
+    }
+
     // 5: Check for hunger.
     snaken->snake_stamina_step++;
     if (snaken->snake_stamina_step <= snaken->snake_stamina) return SNAKEN_ERROR_NONE;
@@ -134,14 +758,27 @@ snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
     // Reset hunger.
     snaken->snake_stamina_step = 0;
 
+    // The head is not part of the body, so it never blocks.
+    if (snaken->snake_length > 1) snaken2d_dist_unblock_body(snaken, snaken->snake_body[snaken->snake_length - 1]);
+
+    event->flags |= SNAKEN_EVENT_SHRANK;
+    event->cut = snaken->snake_body[snaken->snake_length - 1];
+
     // Decrease the snake length.
     snaken->snake_length--;
+    if (snaken->snake_out_length > snaken->snake_length) snaken->snake_out_length = snaken->snake_length;
     if (snaken->snake_length <= 0) {
         // Let the snake die of hunger.
         // Calling free instead of letting realloc free the snake body ensures memory is actually freed,
         // since realloc's behavior with size 0 is implementation-specific, and therefore unpredictable.
         free(snaken->snake_body);
+        snaken->snake_body = NULL;
         snaken->snake_alive = SNAKEN_FALSE;
+
+        if (!(event->flags & SNAKEN_EVENT_DIED)) {
+            event->flags |= SNAKEN_EVENT_DIED;
+            event->death_cause = SNAKEN_DEATH_HUNGER;
+        }
     } else {
         // Chop the snake body off by one.
         snaken->snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, snaken->snake_length * sizeof(snaken_world_size_t));
@@ -153,120 +790,996 @@ snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
     return SNAKEN_ERROR_NONE;
 }
 
-// ##########################################
-// ##########################################
-
-// ##########################################
-// Getter functions.
-// ##########################################
-
-snaken_error_code_t snaken2d_get_snake_view(snaken2d_t* snaken, snaken_cell_type_t* view) {
-    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(snaken->snake_view_radius);
-
-    // Allocate a new array in order to store the unrotated snake view.
-    snaken_cell_type_t* tmp_view = (snaken_cell_type_t*) malloc(snake_view_diameter * snake_view_diameter * sizeof(snaken_cell_type_t));
+snaken_error_code_t snaken2d_tick(snaken2d_t* snaken) {
+    // Dead snakes stay still, a starved one has no body left to move anyway.
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    snaken_event_t event = {
+        .head = SNAKEN_NO_CELL,
+        .tail = SNAKEN_NO_CELL,
+        .cut = SNAKEN_NO_CELL,
+        .apple_from = SNAKEN_NO_CELL,
+        .apple_to = SNAKEN_NO_CELL,
+        .flags = 0x00,
+        .death_cause = SNAKEN_DEATH_NONE
+    };
+
+    snaken_error_code_t error = snaken2d_step(snaken, &event);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    if (snaken->events != NULL) snaken_event_ring_push(snaken->events, &event);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+/// @brief Computes the index in the snake view of the provided unrotated view-space location, rotating it according to snake direction.
+/// @param snaken The snaken the view belongs to.
+/// @param snake_view_diameter The diameter of the view.
+/// @param i The unrotated view-space x location.
+/// @param j The unrotated view-space y location.
+/// @return The index in the view.
+static snaken_world_size_t snaken2d_view_index(
+    snaken2d_t* snaken,
+    snaken_world_size_t snake_view_diameter,
+    snaken_world_size_t i,
+    snaken_world_size_t j
+) {
+    switch (snaken->snake_direction) {
+        case SNAKEN_LEFT:
+            return IDX2D(snake_view_diameter - 1 - j, i, snake_view_diameter);
+        case SNAKEN_RIGHT:
+            return IDX2D(j, snake_view_diameter - 1 - i, snake_view_diameter);
+        case SNAKEN_DOWN:
+            return IDX2D(snake_view_diameter - 1 - i, snake_view_diameter - 1 - j, snake_view_diameter);
+        case SNAKEN_UP:
+        default:
+            return IDX2D(i, j, snake_view_diameter);
+    }
+}
+
+/// @brief Stamps the provided cell type at [location] in the snake view of radius [radius], already rotated according to snake direction.
+/// @param snaken The snaken the view belongs to.
+/// @param radius The radius of the view.
+/// @param location The world location to stamp.
+/// @param cell_type The cell type to stamp.
+/// @param view The view to stamp the cell in.
+static void snaken2d_stamp_view(
+    snaken2d_t* snaken,
+    snaken_world_size_t radius,
+    snaken_world_size_t location,
+    snaken_cell_type_t cell_type,
+    snaken_cell_type_t* view
+) {
+    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(radius);
+    snaken_world_size_t head_x = snaken->snake_body[0] % snaken->world_width;
+    snaken_world_size_t head_y = snaken->snake_body[0] / snaken->world_width;
+
+    // Compute the unrotated view-space location of the cell.
+    // The loops only iterate more than once if the view is larger than the world, in which case the cell is seen multiple times.
+    for (snaken_world_size_t i = WRAP(head_x + radius - (location % snaken->world_width), snaken->world_width); i < snake_view_diameter; i += snaken->world_width) {
+        for (snaken_world_size_t j = WRAP(head_y + radius - (location / snaken->world_width), snaken->world_height); j < snake_view_diameter; j += snaken->world_height) {
+            view[snaken2d_view_index(snaken, snake_view_diameter, i, j)] = cell_type;
+        }
+    }
+}
+
+/// @brief Populates the snake view of radius [radius] by projecting every world element onto it.
+/// @param snaken The snaken to extract the view from.
+/// @param radius The radius of the view.
+/// @param view The view to populate.
+static void snaken2d_fill_view(
+    snaken2d_t* snaken,
+    snaken_world_size_t radius,
+    snaken_cell_type_t* view
+) {
+    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(radius);
+
+    snaken_world_size_t head_x = snaken->snake_body[0] % snaken->world_width;
+    snaken_world_size_t head_y = snaken->snake_body[0] / snaken->world_width;
+
+    // Prepopulate with walls and empty space, looking every view cell up in the walls index, since walls can be arbitrarily many.
+    for (snaken_world_size_t j = 0; j < snake_view_diameter; j++) {
+        for (snaken_world_size_t i = 0; i < snake_view_diameter; i++) {
+            snaken_world_size_t location = IDX2D(
+                WRAP(head_x + radius - i, snaken->world_width),
+                WRAP(head_y + radius - j, snaken->world_height),
+                snaken->world_width
+            );
+            view[snaken2d_view_index(snaken, snake_view_diameter, i, j)] = snaken2d_is_wall(snaken, location) ? SNAKEN_WALL : SNAKEN_EMPTY;
+        }
+    }
+
+    // Stamp the remaining elements by increasing priority, so that higher priority ones overwrite lower priority ones.
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken2d_stamp_view(snaken, radius, snaken->apples[i], SNAKEN_APPLE, view);
+    }
+    for (snaken_world_size_t i = 1; i < snaken->snake_length; i++) {
+        snaken2d_stamp_view(snaken, radius, snaken->snake_body[i], SNAKEN_SNAKE_BODY, view);
+    }
+    snaken2d_stamp_view(snaken, radius, snaken->snake_body[0], SNAKEN_SNAKE_HEAD, view);
+}
+
+snaken_error_code_t snaken2d_get_snake_view(snaken2d_t* snaken, snaken_cell_type_t* view) {
+    // Only visit world elements once instead of looking every view cell up in all of them.
+    snaken2d_fill_view(snaken, snaken->snake_view_radius, view);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Computes the distance at which the ray cast from the snake head along ([ray_x], [ray_y]) first hits [location].
+/// @param snaken The snaken to cast the ray in.
+/// @param location The world location to look for.
+/// @param ray_x The x component of the ray step.
+/// @param ray_y The y component of the ray step.
+/// @param max_dist The maximum distance the ray travels.
+/// @return The hit distance, 0 if [location] is not hit within [max_dist].
+static snaken_world_size_t snaken2d_ray_hit(
+    snaken2d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t ray_x,
+    snaken_world_size_t ray_y,
+    snaken_world_size_t max_dist
+) {
+    snaken_world_size_t head_x = snaken->snake_body[0] % snaken->world_width;
+    snaken_world_size_t head_y = snaken->snake_body[0] / snaken->world_width;
+    snaken_world_size_t location_x = location % snaken->world_width;
+    snaken_world_size_t location_y = location / snaken->world_width;
+
+    // Compute the first distance at which the ray matches the location along one axis, then walk every matching distance
+    // along that axis (one per world wrap) until the other axis matches as well.
+    snaken_world_size_t dist;
+    snaken_world_size_t dist_step;
+    if (ray_x != 0) {
+        dist = WRAP(ray_x * (location_x - head_x), snaken->world_width);
+        dist_step = snaken->world_width;
+    } else {
+        // The ray never leaves the head column.
+        if (location_x != head_x) return 0;
+        dist = WRAP(ray_y * (location_y - head_y), snaken->world_height);
+        dist_step = snaken->world_height;
+    }
+
+    // The head cell itself is only hit again after a full wrap.
+    if (dist == 0) dist = dist_step;
+
+    for (; dist <= max_dist; dist += dist_step) {
+        if (WRAP(head_y + dist * ray_y, snaken->world_height) == location_y) return dist;
+    }
+
+    return 0;
+}
+
+snaken_error_code_t snaken2d_get_rays(
+    snaken2d_t* snaken,
+    snaken_world_size_t max_dist,
+    snaken_world_size_t* rays
+) {
+    for (snaken_world_size_t i = 0; i < (snaken_world_size_t) (SNAKEN_RAYS_COUNT * SNAKEN_RAY_TARGETS_COUNT); i++) {
+        rays[i] = 0;
+    }
+
+    // The snake body is not available once the snake is dead.
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    snaken_world_size_t head_x = snaken->snake_body[0] % snaken->world_width;
+    snaken_world_size_t head_y = snaken->snake_body[0] / snaken->world_width;
+
+    for (snaken_world_size_t r = 0; r < (snaken_world_size_t) SNAKEN_RAYS_COUNT; r++) {
+        // Even rays follow a direction, odd rays go diagonally between two consecutive ones.
+        // Directions are enumerated counter-clockwise, so rotating from the snake direction yields rays in the documented order.
+        snaken_world_size_t ray_x;
+        snaken_world_size_t ray_y;
+        snaken_dir_vector(snaken->snake_direction + r / 2, &ray_x, &ray_y);
+        if (r % 2) {
+            snaken_world_size_t next_x;
+            snaken_world_size_t next_y;
+            snaken_dir_vector(snaken->snake_direction + r / 2 + 1, &next_x, &next_y);
+            ray_x += next_x;
+            ray_y += next_y;
+        }
+
+        snaken_world_size_t* ray = &(rays[r * SNAKEN_RAY_TARGETS_COUNT]);
+
+        // Walls can be looked up per cell, so march along the ray unless there are fewer walls than ray cells.
+        if (max_dist <= snaken->walls_length) {
+            for (snaken_world_size_t dist = 1; dist <= max_dist; dist++) {
+                snaken_world_size_t location = IDX2D(
+                    WRAP(head_x + dist * ray_x, snaken->world_width),
+                    WRAP(head_y + dist * ray_y, snaken->world_height),
+                    snaken->world_width
+                );
+                if (snaken2d_is_wall(snaken, location)) {
+                    ray[SNAKEN_RAY_WALL] = dist;
+                    break;
+                }
+            }
+        } else {
+            for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
+                snaken_world_size_t dist = snaken2d_ray_hit(snaken, snaken->walls[i], ray_x, ray_y, max_dist);
+                if (dist > 0 && (ray[SNAKEN_RAY_WALL] == 0 || dist < ray[SNAKEN_RAY_WALL])) ray[SNAKEN_RAY_WALL] = dist;
+            }
+        }
+
+        // Visit every other world element once per ray and keep the nearest hit, instead of looking every ray cell up in all of them.
+        for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+            snaken_world_size_t dist = snaken2d_ray_hit(snaken, snaken->apples[i], ray_x, ray_y, max_dist);
+            if (dist > 0 && (ray[SNAKEN_RAY_APPLE] == 0 || dist < ray[SNAKEN_RAY_APPLE])) ray[SNAKEN_RAY_APPLE] = dist;
+        }
+
+        // Only consider body sections already out of the starting hole, consistently with [snaken2d_eat_body].
+        for (snaken_world_size_t i = 1; i < snaken->snake_out_length; i++) {
+            snaken_world_size_t dist = snaken2d_ray_hit(snaken, snaken->snake_body[i], ray_x, ray_y, max_dist);
+            if (dist > 0 && (ray[SNAKEN_RAY_BODY] == 0 || dist < ray[SNAKEN_RAY_BODY])) ray[SNAKEN_RAY_BODY] = dist;
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_get_apple_dist(
+    snaken2d_t* snaken,
+    snaken_world_size_t* dist
+) {
+    if (snaken->apple_dist == NULL) {
+        return SNAKEN_ERROR_FEATURE_DISABLED;
+    }
+
+    // Dead snakes have no head, and may even have no body left after starving.
+    if (!snaken->snake_alive) {
+        (*dist) = SNAKEN_DIST_UNREACHABLE;
+        return SNAKEN_ERROR_NONE;
+    }
+
+    snaken_world_size_t head = snaken->snake_body[0];
+    snaken_world_size_t head_dist = snaken->apple_dist[head];
+
+    // The head cell can be blocked by body sections still in the starting hole or overlapping the head,
+    // in which case the path goes through the nearest free neighbor.
+    if (snaken->apple_dist_apples[head] > 0) {
+        head_dist = 0;
+    } else if (snaken->apple_dist_blocks[head] > 0) {
+        for (snaken_world_size_t d = 0; d < 4; d++) {
+            snaken_world_size_t neighbor_dist = snaken->apple_dist[snaken2d_neighbor(snaken, head, d)];
+            if (neighbor_dist != SNAKEN_DIST_INF && neighbor_dist + 1 < head_dist) head_dist = neighbor_dist + 1;
+        }
+    }
+
+    (*dist) = head_dist == SNAKEN_DIST_INF ? SNAKEN_DIST_UNREACHABLE : head_dist;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_obs_layout_init(
+    snaken_obs_layout_t* layout,
+    snaken_world_size_t view_radius
+) {
+    // Number of values fitting in a single alignment unit.
+    const snaken_world_size_t align_values = SNAKEN_OBS_ALIGNMENT / sizeof(snaken_obs_t);
+
+    layout->view_diameter = NH_DIAM_2D(view_radius);
+
+    // Pad planes and features so that every one of them starts on an aligned address.
+    layout->plane_stride = ((layout->view_diameter * layout->view_diameter + align_values - 1) / align_values) * align_values;
+    layout->view_stride = SNAKEN_OBS_CHANNELS * layout->plane_stride;
+    layout->features_stride = ((SNAKEN_OBS_FEATURES + align_values - 1) / align_values) * align_values;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_obs_batch_alloc(
+    snaken_obs_layout_t* layout,
+    snaken_world_size_t count,
+    snaken_obs_t** views,
+    snaken_obs_t** features
+) {
+    // Strides are multiples of the alignment, so sizes are as well, as required by aligned_alloc.
+    (*views) = (snaken_obs_t*) aligned_alloc(SNAKEN_OBS_ALIGNMENT, (size_t) count * layout->view_stride * sizeof(snaken_obs_t));
+    if ((*views) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    (*features) = (snaken_obs_t*) aligned_alloc(SNAKEN_OBS_ALIGNMENT, (size_t) count * layout->features_stride * sizeof(snaken_obs_t));
+    if ((*features) == NULL) {
+        free(*views);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_get_obs(
+    snaken2d_t* snaken,
+    snaken_obs_layout_t* layout,
+    snaken_cell_type_t* scratch,
+    snaken_obs_t* view,
+    snaken_obs_t* feature
+) {
+    snaken_world_size_t view_radius = (layout->view_diameter - 1) / 2;
+    snaken_world_size_t view_cells = layout->view_diameter * layout->view_diameter;
+
+    // Clear the whole padded rows, so that padding never holds garbage.
+    memset(view, 0x00, layout->view_stride * sizeof(snaken_obs_t));
+    memset(feature, 0x00, layout->features_stride * sizeof(snaken_obs_t));
+
+    // The snake body is not available once the snake is dead.
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    snaken2d_fill_view(snaken, view_radius, scratch);
+
+    // One-hot encode the view: each non-empty cell type maps to its own channel.
+    for (snaken_world_size_t i = 0; i < view_cells; i++) {
+        if (scratch[i] != SNAKEN_EMPTY) {
+            view[(scratch[i] - 1) * layout->plane_stride + i] = 1.0f;
+        }
+    }
+
+    feature[0] = (snaken_obs_t) snaken->snake_length;
+    feature[1] = (snaken_obs_t) snaken->snake_stamina_step;
+    feature[2] = (snaken_obs_t) snaken->snake_direction;
+    feature[3] = (snaken_obs_t) snaken->eaten_apples_count;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_get_obs_batch(
+    snaken2d_t** snakens,
+    snaken_world_size_t count,
+    snaken_obs_layout_t* layout,
+    snaken_obs_t* views,
+    snaken_obs_t* features
+) {
+    snaken_world_size_t view_cells = layout->view_diameter * layout->view_diameter;
+
+    // Scratch cell views, one per world so that worlds can be processed independently.
+    snaken_cell_type_t* cell_views = (snaken_cell_type_t*) malloc((size_t) count * view_cells * sizeof(snaken_cell_type_t));
+    if (cell_views == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (snaken_world_size_t n = 0; n < count; n++) {
+        snaken2d_get_obs(
+            snakens[n],
+            layout,
+            cell_views + (size_t) n * view_cells,
+            views + (size_t) n * layout->view_stride,
+            features + (size_t) n * layout->features_stride
+        );
+    }
+
+    free(cell_views);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Rendering functions.
+// ##########################################
+
+/// @brief Fills [count] consecutive pixels with the provided color.
+/// Only the first pixel is written by hand: the span then doubles by copying its own filled part, so that all the work is done by memcpy, which is vectorized.
+/// Gray colors are written with a single memset instead.
+/// @param dst The first pixel to fill.
+/// @param color The color to fill with.
+/// @param count The number of pixels to fill.
+static void snaken_fill_span(
+    uint8_t* dst,
+    snaken_rgb_t color,
+    size_t count
+) {
+    size_t size = count * SNAKEN_RGB_CHANNELS;
+
+    if (color.r == color.g && color.g == color.b) {
+        memset(dst, color.r, size);
+        return;
+    }
+
+    dst[0] = color.r;
+    dst[1] = color.g;
+    dst[2] = color.b;
+    for (size_t filled = SNAKEN_RGB_CHANNELS; filled < size; filled *= 2) {
+        memcpy(dst + filled, dst, filled < size - filled ? filled : size - filled);
+    }
+}
+
+/// @brief Fills the [scale] x [scale] square of the provided cell with the provided color.
+/// @param snaken The world the cell belongs to.
+/// @param location The location of the cell.
+/// @param scale The side of every cell in pixels.
+/// @param color The color to fill the cell with.
+/// @param out The frame to fill the cell in.
+static void snaken2d_fill_cell(
+    snaken2d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t scale,
+    snaken_rgb_t color,
+    uint8_t* out
+) {
+    size_t row_size = (size_t) snaken->world_width * scale * SNAKEN_RGB_CHANNELS;
+    size_t span_size = (size_t) scale * SNAKEN_RGB_CHANNELS;
+    uint8_t* dst = out +
+        (size_t) (location / snaken->world_width) * scale * row_size +
+        (size_t) (location % snaken->world_width) * span_size;
+
+    // Fill the top row of the cell, then copy it down.
+    snaken_fill_span(dst, color, scale);
+    for (snaken_world_size_t y = 1; y < scale; y++) {
+        memcpy(dst + y * row_size, dst, span_size);
+    }
+}
+
+snaken_error_code_t snaken_palette_init(snaken_palette_t* palette) {
+    palette->background = (snaken_rgb_t) {0x00, 0x00, 0x00};
+    palette->wall = (snaken_rgb_t) {0xFF, 0xFF, 0xFF};
+    palette->apple = (snaken_rgb_t) {0xFF, 0x5A, 0x5A};
+    palette->snake_head = (snaken_rgb_t) {0x7F, 0xFF, 0x55};
+    palette->snake_tail = (snaken_rgb_t) {0x11, 0x33, 0x44};
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_render_rgb(
+    snaken2d_t* snaken,
+    snaken_world_size_t scale,
+    snaken_palette_t* palette,
+    uint8_t* out
+) {
+    if (scale <= 0) {
+        return SNAKEN_ERROR_INVALID_SIZE;
+    }
+
+    snaken_palette_t default_palette;
+    if (palette == NULL) {
+        snaken_palette_init(&default_palette);
+        palette = &default_palette;
+    }
+
+    // Rows are contiguous, so the whole background is a single span.
+    snaken_fill_span(out, palette->background, (size_t) snaken->world_width * snaken->world_height * scale * scale);
+
+    // Draw elements by increasing priority, so that higher priority ones overwrite lower priority ones.
+    for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
+        snaken2d_fill_cell(snaken, snaken->walls[i], scale, palette->wall, out);
+    }
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken2d_fill_cell(snaken, snaken->apples[i], scale, palette->apple, out);
+    }
+
+    // The snake body is not available once the snake is dead.
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    // Draw the snake from tail to head, so that the head always shows on top.
+    // The gradient is interpolated in fixed point, since it is evaluated for every section.
+    snaken_world_size_t last = snaken->snake_length > 1 ? snaken->snake_length - 1 : 1;
+    for (snaken_world_size_t i = snaken->snake_length - 1; i >= 0; i--) {
+        snaken_rgb_t color = {
+            (uint8_t) (palette->snake_head.r + ((int32_t) palette->snake_tail.r - palette->snake_head.r) * i / last),
+            (uint8_t) (palette->snake_head.g + ((int32_t) palette->snake_tail.g - palette->snake_head.g) * i / last),
+            (uint8_t) (palette->snake_head.b + ((int32_t) palette->snake_tail.b - palette->snake_head.b) * i / last)
+        };
+        snaken2d_fill_cell(snaken, snaken->snake_body[i], scale, color, out);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_render_rgb_batch(
+    snaken2d_t** snakens,
+    snaken_world_size_t count,
+    snaken_world_size_t scale,
+    snaken_palette_t* palette,
+    uint8_t* out
+) {
+    if (scale <= 0) {
+        return SNAKEN_ERROR_INVALID_SIZE;
+    }
+    if (count <= 0) {
+        return SNAKEN_ERROR_NONE;
+    }
+
+    // Frames are laid out back to back, so all of them need the same size.
+    for (snaken_world_size_t n = 1; n < count; n++) {
+        if (snakens[n]->world_width != snakens[0]->world_width || snakens[n]->world_height != snakens[0]->world_height) {
+            return SNAKEN_ERROR_INVALID_SIZE;
+        }
+    }
+
+    size_t frame_size = (size_t) snakens[0]->world_width * snakens[0]->world_height * scale * scale * SNAKEN_RGB_CHANNELS;
+
+    #pragma omp parallel for schedule(static)
+    for (snaken_world_size_t n = 0; n < count; n++) {
+        snaken2d_render_rgb(snakens[n], scale, palette, out + (size_t) n * frame_size);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Event functions.
+// ##########################################
+
+snaken_error_code_t snaken_event_ring_init(
+    snaken_event_ring_t* ring,
+    snaken_event_t* events,
+    uint32_t capacity
+) {
+    // Counts wrap around, so the capacity needs to divide their range.
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return SNAKEN_ERROR_INVALID_SIZE;
+    }
+
+    ring->events = events;
+    ring->capacity = capacity;
+    ring->write_count = 0;
+    ring->read_count = 0;
+    ring->dropped_count = 0;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_event_ring_pop(
+    snaken_event_ring_t* ring,
+    snaken_event_t* event,
+    snaken_bool_t* result
+) {
+    uint32_t read_count = __atomic_load_n(&(ring->read_count), __ATOMIC_RELAXED);
+
+    (*result) = read_count != __atomic_load_n(&(ring->write_count), __ATOMIC_ACQUIRE);
+    if (!(*result)) return SNAKEN_ERROR_NONE;
+
+    *event = ring->events[read_count & (ring->capacity - 1)];
+    __atomic_store_n(&(ring->read_count), read_count + 1, __ATOMIC_RELEASE);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken_event_ring_get_dropped_count(snaken_event_ring_t* ring, uint32_t* result) {
+    (*result) = __atomic_load_n(&(ring->dropped_count), __ATOMIC_RELAXED);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_set_snake_dir(snaken2d_t* snaken, snaken_dir_t direction) {
+    snaken->snake_direction = direction;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_snake_view_radius(
+    snaken2d_t* snaken,
+    snaken_world_size_t radius
+) {
+    snaken->snake_view_radius = radius;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_snake_length(
+    snaken2d_t* snaken,
+    snaken_world_size_t length
+) {
+    // Release the cells of any body piece about to be chopped off.
+    for (snaken_world_size_t i = length > 1 ? length : 1; i < snaken->snake_length; i++) {
+        snaken2d_dist_unblock_body(snaken, snaken->snake_body[i]);
+    }
+
+    snaken->snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, length * sizeof(snaken_world_size_t));
+    if (snaken->snake_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Place the new body pieces exactly on the existing tail.
+    if (snaken->snake_length < length) {
+        for (snaken_world_size_t i = snaken->snake_length; i < length; i++) {
+            snaken->snake_body[i] = snaken->snake_body[snaken->snake_length - 1];
+            snaken2d_dist_block_body(snaken, snaken->snake_body[i]);
+        }
+    }
+
+    // Only update snake out length if the snake is already all out, and never let it exceed the snake length.
+    if (snaken->snake_out_length == snaken->snake_length || snaken->snake_out_length > length) snaken->snake_out_length = length;
+
+    // Finally update the snake actual length.
+    snaken->snake_length = length;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_apple_dist_tracking(
+    snaken2d_t* snaken,
+    snaken_bool_t enabled
+) {
+    // Nothing to do if already in the requested state.
+    if ((snaken->apple_dist != NULL) == enabled) return SNAKEN_ERROR_NONE;
+
+    if (!enabled) {
+        snaken2d_dist_free(snaken);
+        return SNAKEN_ERROR_NONE;
+    }
+
+    size_t world_size = (size_t) snaken->world_width * snaken->world_height;
+
+    snaken->apple_dist = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    snaken->apple_dist_parents = (uint8_t*) malloc(world_size * sizeof(uint8_t));
+    snaken->apple_dist_blocks = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    snaken->apple_dist_apples = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    snaken->apple_dist_stale = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    snaken->apple_dist_queue = (snaken_world_size_t*) malloc((world_size + 1) * sizeof(snaken_world_size_t));
+    snaken->apple_dist_queued = (uint8_t*) malloc(world_size * sizeof(uint8_t));
+    if (snaken->apple_dist == NULL ||
+        snaken->apple_dist_parents == NULL ||
+        snaken->apple_dist_blocks == NULL ||
+        snaken->apple_dist_apples == NULL ||
+        snaken->apple_dist_stale == NULL ||
+        snaken->apple_dist_queue == NULL ||
+        snaken->apple_dist_queued == NULL) {
+        // Make sure the snaken is left with tracking disabled.
+        snaken2d_dist_free(snaken);
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    snaken2d_dist_rebuild(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_event_ring(snaken2d_t* snaken, snaken_event_ring_t* ring) {
+    snaken->events = ring;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_turn_left(snaken2d_t* snaken) {
+    switch (snaken->snake_direction) {
+        case SNAKEN_UP:
+            snaken->snake_direction = SNAKEN_LEFT;
+            break;
+        case SNAKEN_LEFT:
+            snaken->snake_direction = SNAKEN_DOWN;
+            break;
+        case SNAKEN_DOWN:
+            snaken->snake_direction = SNAKEN_RIGHT;
+            break;
+        case SNAKEN_RIGHT:
+            snaken->snake_direction = SNAKEN_UP;
+            break;
+        default:
+            return SNAKEN_ERROR_INVALID_DIRECTION;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_turn_right(snaken2d_t* snaken) {
+    switch (snaken->snake_direction) {
+        case SNAKEN_UP:
+            snaken->snake_direction = SNAKEN_RIGHT;
+            break;
+        case SNAKEN_LEFT:
+            snaken->snake_direction = SNAKEN_UP;
+            break;
+        case SNAKEN_DOWN:
+            snaken->snake_direction = SNAKEN_LEFT;
+            break;
+        case SNAKEN_RIGHT:
+            snaken->snake_direction = SNAKEN_DOWN;
+            break;
+        default:
+            return SNAKEN_ERROR_INVALID_DIRECTION;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_apply_action(snaken2d_t* snaken, uint8_t action) {
+    switch (action) {
+        case SNAKEN_ACTION_LEFT:
+            return snaken2d_turn_left(snaken);
+        case SNAKEN_ACTION_RIGHT:
+            return snaken2d_turn_right(snaken);
+        default:
+            return SNAKEN_ERROR_NONE;
+    }
+}
+
+snaken_error_code_t snaken2d_set_self_intersect(snaken2d_t* snaken, snaken_bool_t val) {
+    snaken_bool_t changed = snaken->self_intersects != val;
+
+    snaken->self_intersects = val;
+
+    // Whether the body blocks paths depends on self intersection.
+    if (changed) snaken2d_dist_rebuild(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_snake_speed(snaken2d_t* snaken, snaken_snake_speed_t speed) {
+    snaken->snake_speed = speed;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_snake_stamina(snaken2d_t* snaken, snaken_snake_stamina_t stamina) {
+    snaken->snake_stamina = stamina;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_spawn_apple(snaken2d_t* snaken, snaken_world_size_t index) {
+    // Make sure the provided index is in range.
+    if (index >= snaken->apples_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Apples stay where they are in worlds made of walls only.
+    snaken_world_size_t location = snaken2d_random_free_location(snaken, snaken->apples_length);
+    if (location == SNAKEN_NO_CELL) return SNAKEN_ERROR_NONE;
+
+    snaken2d_dist_remove_apple(snaken, snaken->apples[index]);
+    snaken->apples[index] = location;
+    snaken2d_dist_add_apple(snaken, snaken->apples[index]);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_apples_count(snaken2d_t* snaken, snaken_world_size_t apples_count) {
+    // Save the old count for later use.
+    snaken_world_size_t old_apples_count = snaken->apples_length;
+
+    // If the amount of apples decreased, then remove the exceeding ones.
+    for (snaken_world_size_t i = apples_count; i < old_apples_count; i++) {
+        snaken2d_dist_remove_apple(snaken, snaken->apples[i]);
+    }
+
+    // Resize the apples array.
+    snaken->apples_length = apples_count;
+    snaken->apples = (snaken_world_size_t*) realloc(snaken->apples, snaken->apples_length * sizeof(snaken_world_size_t));
+    if (snaken->apples == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // If the amount of apples increased, then spawn new ones.
+    // New slots hold no apple yet, so there is nothing to remove before spawning.
+    // Worlds made of walls only leave no room for them, so they are left on the first cell like map changes leave apples on walls.
+    for (snaken_world_size_t i = old_apples_count; i < snaken->apples_length; i++) {
+        snaken_world_size_t location = snaken2d_random_free_location(snaken, i);
+        snaken->apples[i] = location == SNAKEN_NO_CELL ? 0 : location;
+        snaken2d_dist_add_apple(snaken, snaken->apples[i]);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_reset(snaken2d_t* snaken, uint64_t seed) {
+    snaken->rng = seed;
+
+    // Restore the starting snake, reusing the existing body if the snake did not starve.
+    snaken_world_size_t* snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, SNAKEN_STARTING_SNAKE_LENGTH * sizeof(snaken_world_size_t));
+    if (snake_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->snake_body = snake_body;
+    snaken->snake_length = SNAKEN_STARTING_SNAKE_LENGTH;
+    snaken->snake_out_length = 1;
+    for (snaken_world_size_t i = 0; i < snaken->snake_length; i++) {
+        snaken->snake_body[i] = IDX2D(snaken->world_width / 2, snaken->world_height / 2, snaken->world_width);
+    }
+
+    snaken->snake_speed_step = 0;
+    snaken->snake_stamina_step = 0;
+    snaken->snake_direction = SNAKEN_STARTING_SNAKE_DIR;
+    snaken->snake_alive = SNAKEN_TRUE;
+    snaken->eaten_apples_count = 0;
+
+    // Respawn all apples from the new seed, leaving them in place in worlds made of walls only.
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken_world_size_t location = snaken2d_random_free_location(snaken, i);
+        if (location != SNAKEN_NO_CELL) snaken->apples[i] = location;
+    }
+
+    // Apples and body moved all at once, so rebuild the distance field rather than updating it.
+    snaken2d_dist_rebuild(snaken);
+
+    // Everything moved at once for event consumers as well.
+    if (snaken->events != NULL) {
+        snaken_event_t event = {
+            .head = snaken->snake_body[0],
+            .tail = SNAKEN_NO_CELL,
+            .cut = SNAKEN_NO_CELL,
+            .apple_from = SNAKEN_NO_CELL,
+            .apple_to = SNAKEN_NO_CELL,
+            .flags = SNAKEN_EVENT_RESET,
+            .death_cause = SNAKEN_DEATH_NONE
+        };
+        snaken_event_ring_push(snaken->events, &event);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_set_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
+    // Make sure all walls are in range before changing anything.
+    snaken_error_code_t error = snaken2d_check_walls(snaken, walls_length, walls);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    snaken2d_reset_walls(snaken);
+
+    // Store the provided walls, skipping duplicates. The distance field is rebuilt once afterwards instead of per wall.
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        snaken2d_store_wall(snaken, walls[i]);
+    }
+
+    // The provided walls were copied, so they are not needed anymore.
+    free(walls);
+
+    snaken2d_dist_rebuild(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_add_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
+    // Make sure all walls are in range before changing anything.
+    snaken_error_code_t error = snaken2d_check_walls(snaken, walls_length, walls);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Add all provided walls, skipping the ones already present.
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        snaken2d_insert_wall(snaken, walls[i]);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_remove_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
+    // Make sure all walls are in range before changing anything.
+    snaken_error_code_t error = snaken2d_check_walls(snaken, walls_length, walls);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Remove all provided walls, skipping the ones not present.
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        snaken2d_erase_wall(snaken, walls[i]);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_fill_walls_rect(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+) {
+    snaken_error_code_t error = snaken2d_check_rect(snaken, x, y, width, height);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    for (snaken_world_size_t j = y; j < y + height; j++) {
+        for (snaken_world_size_t i = x; i < x + width; i++) {
+            snaken2d_insert_wall(snaken, IDX2D(i, j, snaken->world_width));
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken2d_clear_walls_rect(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+) {
+    snaken_error_code_t error = snaken2d_check_rect(snaken, x, y, width, height);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-    // Populate the resulting snake view.
-    for (snaken_world_size_t j = 0; j < snake_view_diameter; j++) {
-        // Compute world-space j.
-        // snaken_world_size_t global_j = (snaken->snake_body[0] / snaken->world_width) - j - snaken->snake_view_radius;
-        snaken_world_size_t global_j = ((snaken->snake_body[0] / snaken->world_width) - j + snaken->snake_view_radius) % snaken->world_height;
-        // snaken_world_size_t global_j = (snaken->snake_body[0] / snaken->world_width) - (snake_view_diameter - j);
-        for (snaken_world_size_t i = 0; i < snake_view_diameter; i++) {
-            // Compute world-space i.
-            // snaken_world_size_t global_i = (snaken->snake_body[0] % snaken->world_width) - i - snaken->snake_view_radius;
-            snaken_world_size_t global_i = ((snaken->snake_body[0] % snaken->world_width) - i + snaken->snake_view_radius) % snaken->world_width;
-            // snaken_world_size_t global_i = (snaken->snake_body[0] % snaken->world_width) - (snake_view_diameter - i);
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-            snaken_world_size_t local_location = IDX2D(i, j, snake_view_diameter);
-            snaken_world_size_t global_location = IDX2D(global_i, global_j, snaken->world_width);
+    for (snaken_world_size_t j = y; j < y + height; j++) {
+        for (snaken_world_size_t i = x; i < x + width; i++) {
+            snaken2d_erase_wall(snaken, IDX2D(i, j, snaken->world_width));
+        }
+    }
 
-            // Prepopulate with empty space.
-            tmp_view[local_location] = SNAKEN_EMPTY;
+    return SNAKEN_ERROR_NONE;
+}
 
-            // Check for snake head.
-            if (snaken->snake_body[0] == global_location) {
-                tmp_view[local_location] = SNAKEN_SNAKE_HEAD;
-                continue;
-            }
+snaken_error_code_t snaken2d_update_walls_mask(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height,
+    uint8_t* mask,
+    snaken_bool_t val
+) {
+    snaken_error_code_t error = snaken2d_check_rect(snaken, x, y, width, height);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-            // Check for snake body.
-            snaken_bool_t snake_found = SNAKEN_FALSE;
-            for (snaken_world_size_t k = 1; k < snaken->snake_length; k++) {
-                if (snaken->snake_body[k] == global_location) {
-                    tmp_view[local_location] = SNAKEN_SNAKE_BODY;
-                    snake_found = SNAKEN_TRUE;
-                    break;
-                }
-            }
-            if (snake_found) {
-                continue;
-            }
+    // Walls are about to change, so make sure they are not shared.
+    error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-            // Check for apples.
-            snaken_bool_t apple_found = SNAKEN_FALSE;
-            for (snaken_world_size_t k = 0; k < snaken->apples_length; k++) {
-                if (snaken->apples[k] == global_location) {
-                    tmp_view[local_location] = SNAKEN_APPLE;
-                    apple_found = SNAKEN_TRUE;
-                    break;
-                }
-            }
-            if (apple_found) {
-                continue;
-            }
+    for (snaken_world_size_t j = 0; j < height; j++) {
+        for (snaken_world_size_t i = 0; i < width; i++) {
+            // Cells left out of the mask are not touched.
+            if (!mask[IDX2D(i, j, width)]) continue;
 
-            // Check for walls.
-            snaken_bool_t wall_found = SNAKEN_FALSE;
-            for (snaken_world_size_t k = 0; k < snaken->walls_length; k++) {
-                if (snaken->walls[k] == global_location) {
-                    tmp_view[local_location] = SNAKEN_WALL;
-                    wall_found = SNAKEN_TRUE;
-                    break;
-                }
-            }
-            if (wall_found) {
-                continue;
+            snaken_world_size_t location = IDX2D(x + i, y + j, snaken->world_width);
+            if (val) {
+                snaken2d_insert_wall(snaken, location);
+            } else {
+                snaken2d_erase_wall(snaken, location);
             }
         }
     }
 
-    // Rotate the view according to snake direction.
-    switch (snaken->snake_direction) {
-        case SNAKEN_LEFT:
-            for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
-                for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
-                    view[IDX2D(x, y, snake_view_diameter)] = tmp_view[IDX2D(y, snake_view_diameter - 1 - x, snake_view_diameter)];
-                }
-            }
-            break;
-        case SNAKEN_RIGHT:
-            for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
-                for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
-                    view[IDX2D(x, y, snake_view_diameter)] = tmp_view[IDX2D(snake_view_diameter - 1 - y, x, snake_view_diameter)];
-                }
-            }
-            break;
-        case SNAKEN_DOWN:
-            for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
-                for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
-                    view[IDX2D(x, y, snake_view_diameter)] = tmp_view[IDX2D(snake_view_diameter - 1 - x, snake_view_diameter - 1 - y, snake_view_diameter)];
-                }
-            }
-            break;
-        case SNAKEN_UP:
-            for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
-                for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
-                    view[IDX2D(x, y, snake_view_diameter)] = tmp_view[IDX2D(x, y, snake_view_diameter)];
-                }
-            }
-            break;
-        default:
-            break;
-    }
-
-    free(tmp_view);
-
     return SNAKEN_ERROR_NONE;
 }
 
@@ -275,200 +1788,331 @@ snaken_error_code_t snaken2d_get_snake_view(snaken2d_t* snaken, snaken_cell_type
 
 
 // ##########################################
-// Setter functions.
+// Map generation functions.
 // ##########################################
 
-snaken_error_code_t snaken2d_set_snake_dir(snaken2d_t* snaken, snaken_dir_t direction) {
-    snaken->snake_direction = direction;
+/// @brief Puts a wall on every cell of the world, leaving the distance field untouched.
+/// @param snaken The snaken to fill with walls.
+static void snaken2d_store_all_walls(
+    snaken2d_t* snaken
+) {
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
 
-    return SNAKEN_ERROR_NONE;
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        snaken->walls_index[i] = i;
+        snaken->walls[i] = i;
+    }
+    snaken->walls_length = world_size;
 }
 
-snaken_error_code_t snaken2d_set_snake_view_radius(
-    snaken2d_t* snaken,
-    snaken_world_size_t radius
+/// @brief Makes a freshly generated map playable: the snake body is freed from walls, apples on walls are moved and the
+/// distance field is rebuilt once for the whole map.
+/// @param snaken The snaken whose map was generated.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken2d_finish_map(
+    snaken2d_t* snaken
 ) {
-    snaken->snake_view_radius = radius;
+    if (snaken->snake_alive) {
+        for (snaken_world_size_t i = 0; i < snaken->snake_length; i++) {
+            snaken2d_discard_wall(snaken, snaken->snake_body[i]);
+        }
+    }
+
+    // A map made of walls only leaves no room for apples.
+    if (snaken->walls_length >= snaken->world_width * snaken->world_height) {
+        snaken2d_dist_rebuild(snaken);
+        return SNAKEN_ERROR_NONE;
+    }
+
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        if (snaken2d_is_wall(snaken, snaken->apples[i])) snaken->apples[i] = snaken2d_random_free_location(snaken, snaken->apples_length);
+    }
+
+    snaken2d_dist_rebuild(snaken);
 
     return SNAKEN_ERROR_NONE;
 }
 
-snaken_error_code_t snaken2d_set_snake_length(
+/// @brief Removes walls from every cell of the provided rectangle, clipped to the world, leaving the distance field untouched.
+/// @param snaken The snaken to carve the rectangle in.
+/// @param x The x location of the top left corner of the rectangle.
+/// @param y The y location of the top left corner of the rectangle.
+/// @param width The width of the rectangle.
+/// @param height The height of the rectangle.
+static void snaken2d_carve_rect(
     snaken2d_t* snaken,
-    snaken_world_size_t length
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
 ) {
-    snaken->snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, length * sizeof(snaken_world_size_t));
-    if (snaken->snake_body == NULL) {
-        return SNAKEN_ERROR_FAILED_ALLOC;
+    for (snaken_world_size_t j = y; j < y + height && j < snaken->world_height; j++) {
+        for (snaken_world_size_t i = x; i < x + width && i < snaken->world_width; i++) {
+            snaken2d_discard_wall(snaken, IDX2D(i, j, snaken->world_width));
+        }
     }
+}
 
-    // Place the new body pieces exactly on the existing tail.
-    if (snaken->snake_length < length) {
-        for (snaken_world_size_t i = snaken->snake_length; i < length; i++) {
-            snaken->snake_body[i] = snaken->snake_body[snaken->snake_length - 1];
-        }
+snaken_error_code_t snaken2d_generate_rooms(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    snaken_world_size_t rooms_count,
+    snaken_world_size_t min_room_size,
+    snaken_world_size_t max_room_size
+) {
+    if (rooms_count <= 0 || min_room_size <= 0 || max_room_size < min_room_size ||
+        max_room_size > snaken->world_width || max_room_size > snaken->world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
     }
 
-    // Only update snake out length if the snake is already all out.
-    if (snaken->snake_out_length == snaken->snake_length) snaken->snake_out_length = length;
+    snaken_error_code_t error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-    // Finally update the snake actual length.
-    snaken->snake_length = length;
+    snaken_rng_t rng = seed;
 
-    return SNAKEN_ERROR_NONE;
-}
+    snaken2d_store_all_walls(snaken);
 
-snaken_error_code_t snaken2d_turn_left(snaken2d_t* snaken) {
-    switch (snaken->snake_direction) {
-        case SNAKEN_UP:
-            snaken->snake_direction = SNAKEN_LEFT;
-            break;
-        case SNAKEN_LEFT:
-            snaken->snake_direction = SNAKEN_DOWN;
-            break;
-        case SNAKEN_DOWN:
-            snaken->snake_direction = SNAKEN_RIGHT;
-            break;
-        case SNAKEN_RIGHT:
-            snaken->snake_direction = SNAKEN_UP;
-            break;
-        default:
-            return SNAKEN_ERROR_INVALID_DIRECTION;
+    snaken_world_size_t prev_x = 0;
+    snaken_world_size_t prev_y = 0;
+    for (snaken_world_size_t r = 0; r < rooms_count; r++) {
+        snaken_world_size_t width = min_room_size + snaken_rng_range(&rng, max_room_size - min_room_size + 1);
+        snaken_world_size_t height = min_room_size + snaken_rng_range(&rng, max_room_size - min_room_size + 1);
+        snaken_world_size_t x = snaken_rng_range(&rng, snaken->world_width - width + 1);
+        snaken_world_size_t y = snaken_rng_range(&rng, snaken->world_height - height + 1);
+
+        snaken2d_carve_rect(snaken, x, y, width, height);
+
+        // Connect the room center to the previous one with an L-shaped corridor, so that all rooms are reachable.
+        snaken_world_size_t center_x = x + width / 2;
+        snaken_world_size_t center_y = y + height / 2;
+        if (r > 0) {
+            snaken_world_size_t min_x = prev_x < center_x ? prev_x : center_x;
+            snaken_world_size_t min_y = prev_y < center_y ? prev_y : center_y;
+            snaken2d_carve_rect(snaken, min_x, prev_y, abs(center_x - prev_x) + 1, 1);
+            snaken2d_carve_rect(snaken, center_x, min_y, 1, abs(center_y - prev_y) + 1);
+        }
+        prev_x = center_x;
+        prev_y = center_y;
     }
 
-    return SNAKEN_ERROR_NONE;
+    return snaken2d_finish_map(snaken);
 }
 
-snaken_error_code_t snaken2d_turn_right(snaken2d_t* snaken) {
-    switch (snaken->snake_direction) {
-        case SNAKEN_UP:
-            snaken->snake_direction = SNAKEN_RIGHT;
-            break;
-        case SNAKEN_LEFT:
-            snaken->snake_direction = SNAKEN_UP;
-            break;
-        case SNAKEN_DOWN:
-            snaken->snake_direction = SNAKEN_LEFT;
-            break;
-        case SNAKEN_RIGHT:
-            snaken->snake_direction = SNAKEN_DOWN;
-            break;
-        default:
-            return SNAKEN_ERROR_INVALID_DIRECTION;
+snaken_error_code_t snaken2d_generate_maze(
+    snaken2d_t* snaken,
+    uint64_t seed
+) {
+    // Maze cells lie on odd coordinates, with walls in between, so at least one of them must fit.
+    snaken_world_size_t cells_width = (snaken->world_width - 1) / 2;
+    snaken_world_size_t cells_height = (snaken->world_height - 1) / 2;
+    if (cells_width <= 0 || cells_height <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
     }
 
-    return SNAKEN_ERROR_NONE;
-}
-snaken_error_code_t snaken2d_set_self_intersect(snaken2d_t* snaken, snaken_bool_t val) {
-    snaken->self_intersects = val;
+    snaken_error_code_t error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-    return SNAKEN_ERROR_NONE;
+    snaken_rng_t rng = seed;
+
+    snaken2d_store_all_walls(snaken);
+
+    // Sidewinder: every row is split into random runs of cells, each joined to the row above through one random cell.
+    // It yields a perfect maze while only remembering where the current run started.
+    for (snaken_world_size_t j = 0; j < cells_height; j++) {
+        snaken_world_size_t run_start = 0;
+        for (snaken_world_size_t i = 0; i < cells_width; i++) {
+            snaken2d_discard_wall(snaken, IDX2D(2 * i + 1, 2 * j + 1, snaken->world_width));
+
+            snaken_bool_t run_end = (i == cells_width - 1) || (j > 0 && snaken_rng_range(&rng, 2) == 0);
+            if (!run_end) {
+                // Carve east.
+                snaken2d_discard_wall(snaken, IDX2D(2 * i + 2, 2 * j + 1, snaken->world_width));
+            } else if (j > 0) {
+                // Carve north from a random cell of the run.
+                snaken_world_size_t cell = run_start + snaken_rng_range(&rng, i - run_start + 1);
+                snaken2d_discard_wall(snaken, IDX2D(2 * cell + 1, 2 * j, snaken->world_width));
+                run_start = i + 1;
+            }
+        }
+    }
+
+    return snaken2d_finish_map(snaken);
 }
 
-snaken_error_code_t snaken2d_set_snake_speed(snaken2d_t* snaken, snaken_snake_speed_t speed) {
-    snaken->snake_speed = speed;
+/// @brief Replaces all walls with random ones, leaving the distance field untouched.
+/// @param snaken The snaken to scatter walls in.
+/// @param seed The seed of the generated walls.
+/// @param density The probability of every cell to hold a wall.
+static void snaken2d_scatter_walls(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    float density
+) {
+    snaken_rng_t rng = seed;
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
 
-    return SNAKEN_ERROR_NONE;
+    snaken2d_reset_walls(snaken);
+
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        if (snaken_rng_float(&rng) < density) snaken2d_store_wall(snaken, i);
+    }
 }
 
-snaken_error_code_t snaken2d_set_snake_stamina(snaken2d_t* snaken, snaken_snake_stamina_t stamina) {
-    snaken->snake_stamina = stamina;
+snaken_error_code_t snaken2d_generate_obstacles(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    float density
+) {
+    snaken_error_code_t error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
 
-    return SNAKEN_ERROR_NONE;
+    snaken2d_scatter_walls(snaken, seed, density);
+
+    return snaken2d_finish_map(snaken);
 }
 
-snaken_error_code_t snaken2d_spawn_apple(snaken2d_t* snaken, snaken_world_size_t index) {
-    // Make sure the provided index is in range.
-    if (index > snaken->world_width * snaken->world_height) {
-        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+snaken_error_code_t snaken2d_generate_caves(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    float density,
+    snaken_world_size_t iterations
+) {
+    snaken_error_code_t error = snaken2d_own_walls(snaken);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
     }
 
-    // Setup variables for location generation.
-    snaken_world_size_t apple_x;
-    snaken_world_size_t apple_y;
-    snaken_world_size_t apple_location;
-    snaken_bool_t location_free = SNAKEN_TRUE;
-
-    do {
-        // Compute a random location for the apple.
-        apple_x = rand() % snaken->world_width;
-        apple_y = rand() % snaken->world_height;
-        apple_location = IDX2D(apple_x, apple_y, snaken->world_width);
+    // Start from random noise.
+    snaken2d_scatter_walls(snaken, seed, density);
+
+    // Smooth the noise into caves: cells surrounded by 5 or more walls become walls, cells with less than 4 become empty.
+    // Cells are updated in place in scan order, which avoids a second world buffer and is just as reproducible.
+    for (snaken_world_size_t k = 0; k < iterations; k++) {
+        for (snaken_world_size_t y = 0; y < snaken->world_height; y++) {
+            for (snaken_world_size_t x = 0; x < snaken->world_width; x++) {
+                snaken_world_size_t neighbors = 0;
+                for (snaken_world_size_t j = -1; j <= 1; j++) {
+                    for (snaken_world_size_t i = -1; i <= 1; i++) {
+                        if (i == 0 && j == 0) continue;
+                        neighbors += snaken2d_is_wall(
+                            snaken,
+                            IDX2D(WRAP(x + i, snaken->world_width), WRAP(y + j, snaken->world_height), snaken->world_width)
+                        );
+                    }
+                }
 
-        // Make sure the picked location is free from walls.
-        for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
-            if (snaken->walls[i] == apple_location) {
-                location_free = SNAKEN_FALSE;
-                break;
+                snaken_world_size_t location = IDX2D(x, y, snaken->world_width);
+                if (neighbors >= 5) {
+                    snaken2d_store_wall(snaken, location);
+                } else if (neighbors < 4) {
+                    snaken2d_discard_wall(snaken, location);
+                }
             }
         }
+    }
 
-        // Make sure the picked location is free from other apples.
-        // for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
-        //     if (snaken->apples[i] == apple_location) {
-        //         location_free = SNAKEN_FALSE;
-        //         break;
-        //     }
-        // }
-    } while(!location_free);
-
-    snaken->apples[index] = apple_location;
-    return SNAKEN_ERROR_NONE;
+    return snaken2d_finish_map(snaken);
 }
 
-snaken_error_code_t snaken2d_set_apples_count(snaken2d_t* snaken, snaken_world_size_t apples_count) {
-    // Save the old count for later use.
-    snaken_world_size_t old_apples_count = snaken->apples_length;
+// ##########################################
+// ##########################################
 
-    // Resize the apples array.
-    snaken->apples_length = apples_count;
-    snaken->apples = (snaken_world_size_t*) realloc(snaken->apples, snaken->apples_length * sizeof(snaken_world_size_t));
-    if (snaken->apples == NULL) {
+
+// ##########################################
+// Shared map functions.
+// ##########################################
+
+snaken_error_code_t snaken2d_map_create(snaken2d_map_t** map, snaken2d_t* snaken) {
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height;
+
+    // Allocate the map.
+    (*map) = (snaken2d_map_t*) malloc(sizeof(snaken2d_map_t));
+    if ((*map) == NULL) {
         return SNAKEN_ERROR_FAILED_ALLOC;
     }
 
-    // If the amount of apples increased, then spawn new ones.
-    for (snaken_world_size_t i = old_apples_count; i < snaken->apples_length; i++) {
-        snaken2d_spawn_apple(snaken, i);
+    // Only allocate as many walls as there are, since the map never changes.
+    (*map)->world_width = snaken->world_width;
+    (*map)->world_height = snaken->world_height;
+    (*map)->walls_length = snaken->walls_length;
+    (*map)->walls = (snaken_world_size_t*) malloc(snaken->walls_length * sizeof(snaken_world_size_t));
+    (*map)->walls_index = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    if (((*map)->walls == NULL && snaken->walls_length > 0) || (*map)->walls_index == NULL) {
+        free((*map)->walls);
+        free((*map)->walls_index);
+        free(*map);
+        (*map) = NULL;
+        return SNAKEN_ERROR_FAILED_ALLOC;
     }
+    memcpy((*map)->walls, snaken->walls, snaken->walls_length * sizeof(snaken_world_size_t));
+    memcpy((*map)->walls_index, snaken->walls_index, world_size * sizeof(snaken_world_size_t));
+
+    (*map)->refs = 1;
 
     return SNAKEN_ERROR_NONE;
 }
 
-snaken_error_code_t snaken2d_set_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
-    // Update the current walls length.
-    snaken->walls_length = walls_length;
+snaken_error_code_t snaken2d_map_release(snaken2d_map_t* map) {
+    snaken_world_size_t refs;
 
-    // Free the existing walls.
-    free(snaken->walls);
+    // Worlds sharing a map can be released from different threads.
+    #pragma omp atomic capture
+    refs = --map->refs;
 
-    // Store the provided walls.
-    snaken->walls = walls;
+    if (refs > 0) return SNAKEN_ERROR_NONE;
+
+    free(map->walls);
+    free(map->walls_index);
+    free(map);
 
     return SNAKEN_ERROR_NONE;
 }
 
-snaken_error_code_t snaken2d_add_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
-    // Save the previous length for later use.
-    snaken_world_size_t old_walls_length = snaken->walls_length;
+snaken_error_code_t snaken2d_attach_map(snaken2d_t* snaken, snaken2d_map_t* map) {
+    if (map->world_width != snaken->world_width || map->world_height != snaken->world_height) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
 
-    // Increase the walls size.
-    snaken->walls_length += walls_length;
+    if (snaken->map == map) return SNAKEN_ERROR_NONE;
 
-    // Resize the walls array.
-    snaken->walls = (snaken_world_size_t*) realloc(snaken->walls, snaken->walls_length * sizeof(snaken_world_size_t));
-    if (snaken->walls == NULL) {
-        return SNAKEN_ERROR_FAILED_ALLOC;
+    #pragma omp atomic
+    map->refs++;
+
+    // Drop the current walls.
+    if (snaken->map != NULL) {
+        snaken2d_map_release(snaken->map);
+    } else {
+        free(snaken->walls);
+        free(snaken->walls_index);
     }
 
-    // Add all provided walls.
-    for (snaken_world_size_t i = 0; i < walls_length; i++) {
-        snaken->walls[i + old_walls_length] = walls[i];
+    snaken->map = map;
+    snaken->walls_length = map->walls_length;
+    snaken->walls = map->walls;
+    snaken->walls_index = map->walls_index;
+
+    // A map made of walls only leaves no room for apples.
+    if (snaken->walls_length < snaken->world_width * snaken->world_height) {
+        for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+            if (snaken2d_is_wall(snaken, snaken->apples[i])) snaken->apples[i] = snaken2d_random_free_location(snaken, snaken->apples_length);
+        }
     }
 
+    snaken2d_dist_rebuild(snaken);
+
     return SNAKEN_ERROR_NONE;
 }
 
+snaken_error_code_t snaken2d_detach_map(snaken2d_t* snaken) {
+    return snaken2d_own_walls(snaken);
+}
+
 // ##########################################
 // ##########################################
 
@@ -524,6 +2168,12 @@ snaken_error_code_t snaken2d_move_snake(snaken2d_t* snaken) {
         section_location = old_location;
     }
 
+    // The old head location is now covered by the neck, while the old tail location was left behind.
+    if (snaken->snake_length > 1) {
+        snaken2d_dist_block_body(snaken, snaken->snake_body[1]);
+        snaken2d_dist_unblock_body(snaken, section_location);
+    }
+
     // Get out of the starting hole a bit.
     if (snaken->snake_out_length < snaken->snake_length) snaken->snake_out_length++;
 
@@ -531,51 +2181,24 @@ snaken_error_code_t snaken2d_move_snake(snaken2d_t* snaken) {
 }
 
 snaken_error_code_t snaken2d_eat_apple(snaken2d_t* snaken, snaken_bool_t* result) {
-    (*result) = SNAKEN_FALSE;
-
-    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
-        // The snake head can be at most on one apple, so leave as soon as one is found.
-        if (snaken->snake_body[0] == snaken->apples[i]) {
-            // An apple was found, so eat it and increase the snake length:
-            (*result) = SNAKEN_TRUE;
-
-            // Increase the number of eaten apples.
-            snaken->eaten_apples_count++;
+    snaken_world_size_t index = snaken2d_find_apple(snaken, snaken->snake_body[0]);
 
-            // Eat the apple and spawn a new one.
-            snaken2d_spawn_apple(snaken, i);
+    // An apple was found, so eat it and increase the snake length.
+    (*result) = index != SNAKEN_NO_CELL;
+    if (!(*result)) return SNAKEN_ERROR_NONE;
 
-            // Increase the snake length.
-            snaken->snake_length++;
-            snaken->snake_body = (snaken_world_size_t*) realloc(snaken->snake_body, snaken->snake_length * sizeof(snaken_world_size_t));
-            if (snaken->snake_body == NULL) {
-                return SNAKEN_ERROR_FAILED_ALLOC;
-            }
-
-            // Reset stamina step.
-            snaken->snake_stamina_step = 0;
-
-            break;
-        }
-    }
-
-    return SNAKEN_ERROR_NONE;
+    return snaken2d_eat_apple_at(snaken, index);
 }
 
 snaken_error_code_t snaken2d_hit_wall(snaken2d_t* snaken, snaken_bool_t* result) {
     (*result) = SNAKEN_FALSE;
 
-    for (snaken_world_size_t i = 0; i < snaken->walls_length; i++) {
-        // The snake head can be at most on one wall, so leave as soon as one is found.
-        if (snaken->snake_body[0] == snaken->walls[i]) {
-            // A wall was found, so hit it and let the snake die:
-            (*result) = SNAKEN_TRUE;
-
-            // Let the snake die.
-            snaken->snake_alive = SNAKEN_FALSE;
+    if (snaken2d_is_wall(snaken, snaken->snake_body[0])) {
+        // A wall was found, so hit it and let the snake die:
+        (*result) = SNAKEN_TRUE;
 
-            break;
-        }
+        // Let the snake die.
+        snaken->snake_alive = SNAKEN_FALSE;
     }
 
     return SNAKEN_ERROR_NONE;
@@ -14,6 +14,7 @@ Copyright (C) 2024 Luka Micheletti
 #include <string.h>
 
 #include "error.h"
+#include "utils.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,7 +24,7 @@ extern "C" {
 // WARNING: Only works with signed types and does not show errors otherwise.
 // [i] is the given index.
 // [n] is the size over which to wrap.
-#define WRAP(i, n) ((i) >= 0 ? ((i) % (n)) : ((n) + ((i) % (n))))
+#define WRAP(i, n) ((i) >= 0 ? ((i) % (n)) : (((n) + ((i) % (n))) % (n)))
 
 // Computes the diameter of a square neighborhood given its radius.
 #define NH_DIAM_2D(r) (2 * (r) + 1)
@@ -62,6 +63,19 @@ typedef enum {
     SNAKEN_RIGHT = 0x03
 } snaken_dir_t;
 
+// Actions controlling a snake, relative to its direction.
+typedef enum {
+    SNAKEN_ACTION_NONE = 0x00,
+    SNAKEN_ACTION_LEFT = 0x01,
+    SNAKEN_ACTION_RIGHT = 0x02
+} snaken_action_t;
+
+typedef enum {
+    SNAKEN_RAY_WALL = 0x00,
+    SNAKEN_RAY_APPLE = 0x01,
+    SNAKEN_RAY_BODY = 0x02
+} snaken_ray_target_t;
+
 typedef enum {
     SNAKEN_EMPTY = 0x00,
     SNAKEN_SNAKE_HEAD = 0x01,
@@ -85,6 +99,146 @@ typedef enum {
 #define SNAKEN_STARTING_SNAKE_LENGTH 0x05u
 #define SNAKEN_STARTING_SNAKE_DIR SNAKEN_UP
 
+// Walls index value of cells holding no wall.
+#define SNAKEN_NO_WALL -1
+
+// Distance reported for cells from which no apple can be reached.
+#define SNAKEN_DIST_UNREACHABLE -1
+
+// Number of one-hot channels in a batched observation (snake head, snake body, apple, wall).
+#define SNAKEN_OBS_CHANNELS 0x04u
+
+// Number of scalar features in a batched observation (length, stamina step, direction, eaten apples).
+#define SNAKEN_OBS_FEATURES 0x04u
+
+// Byte alignment of every plane and feature row in a batched observation, large enough for any vector load.
+#define SNAKEN_OBS_ALIGNMENT 0x40u
+
+// Number of rays cast around the snake head, starting from its front and going counter-clockwise.
+#define SNAKEN_RAYS_COUNT 0x08u
+
+// Number of targets each ray looks for, see [snaken_ray_target_t].
+#define SNAKEN_RAY_TARGETS_COUNT 0x03u
+
+// Value type of batched observations, directly consumable by NN inference.
+typedef float snaken_obs_t;
+
+// Number of bytes in every pixel of a rendered frame.
+#define SNAKEN_RGB_CHANNELS 0x03u
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} snaken_rgb_t;
+
+// Colors of every world element in rendered frames.
+typedef struct {
+    snaken_rgb_t background;
+    snaken_rgb_t wall;
+    snaken_rgb_t apple;
+
+    // The snake is colored with a gradient going from its head to its tail.
+    snaken_rgb_t snake_head;
+    snaken_rgb_t snake_tail;
+} snaken_palette_t;
+
+// Cell value of event fields holding no cell.
+#define SNAKEN_NO_CELL -1
+
+// Changes made to a world by a tick, combined in the flags of a [snaken_event_t].
+typedef enum {
+    // The snake head entered a new cell and a body section left one.
+    SNAKEN_EVENT_MOVED = 0x01,
+    // The snake ate an apple, gaining a section on its tail, and the apple respawned elsewhere.
+    SNAKEN_EVENT_GREW = 0x02,
+    // The snake lost its tail section to hunger.
+    SNAKEN_EVENT_SHRANK = 0x04,
+    // The snake died, see [snaken_death_cause_t].
+    SNAKEN_EVENT_DIED = 0x08,
+    // The world was reset, so it needs to be read as a whole again.
+    SNAKEN_EVENT_RESET = 0x10
+} snaken_event_flag_t;
+
+typedef enum {
+    SNAKEN_DEATH_NONE = 0x00,
+    SNAKEN_DEATH_WALL = 0x01,
+    SNAKEN_DEATH_BODY = 0x02,
+    SNAKEN_DEATH_HUNGER = 0x03
+} snaken_death_cause_t;
+
+// Changes made to a world by a single tick, or by a reset.
+typedef struct {
+    // Cell entered by the snake head, [SNAKEN_NO_CELL] unless moved. On resets, the starting head cell.
+    snaken_world_size_t head;
+
+    // Cell left by a body section, [SNAKEN_NO_CELL] unless moved. Other sections may still lie on it.
+    snaken_world_size_t tail;
+
+    // Cell of the section lost to hunger, [SNAKEN_NO_CELL] unless shrank.
+    snaken_world_size_t cut;
+
+    // Cell of the eaten apple and cell it respawned on, [SNAKEN_NO_CELL] unless grew.
+    snaken_world_size_t apple_from;
+    snaken_world_size_t apple_to;
+
+    // Changes made, see [snaken_event_flag_t].
+    uint8_t flags;
+
+    // Why the snake died, see [snaken_death_cause_t].
+    uint8_t death_cause;
+} snaken_event_t;
+
+// Ring of events written by a world and read by a single consumer, possibly on another thread.
+// Events are stored in caller provided memory, so that worlds never allocate for them.
+typedef struct {
+    snaken_event_t* events;
+
+    // Number of events the ring can hold, a power of two.
+    uint32_t capacity;
+
+    // Number of events ever written and read, wrapping around.
+    // Plain counters only ever accessed through atomic builtins, so that the header stays usable from C++.
+    uint32_t write_count;
+    uint32_t read_count;
+
+    // Number of events dropped because the ring was full, see [snaken_event_ring_get_dropped_count].
+    uint32_t dropped_count;
+} snaken_event_ring_t;
+
+typedef struct {
+    // Diameter of the square view.
+    snaken_world_size_t view_diameter;
+
+    // Distance (in values) between two consecutive channel planes, padded to [SNAKEN_OBS_ALIGNMENT].
+    snaken_world_size_t plane_stride;
+
+    // Distance (in values) between the views of two consecutive worlds.
+    snaken_world_size_t view_stride;
+
+    // Distance (in values) between the features of two consecutive worlds, padded to [SNAKEN_OBS_ALIGNMENT].
+    snaken_world_size_t features_stride;
+} snaken_obs_layout_t;
+
+// Read-only wall layer shared by any number of worlds of the same size.
+typedef struct {
+    // World size.
+    snaken_world_size_t world_width;
+    snaken_world_size_t world_height;
+
+    // Length of walls array.
+    snaken_world_size_t walls_length;
+
+    // Walls array, holding every wall location once.
+    snaken_world_size_t* walls;
+
+    // Position of every cell in the walls array, [SNAKEN_NO_WALL] if the cell holds no wall.
+    snaken_world_size_t* walls_index;
+
+    // Number of references to the map: one for its creator and one for every attached world.
+    snaken_world_size_t refs;
+} snaken2d_map_t;
+
 typedef struct {
     // ################
     // World properties.
@@ -105,9 +259,17 @@ typedef struct {
     // Length of walls array.
     snaken_world_size_t walls_length;
 
-    // Walls array.
+    // Walls array, holding every wall location once. Its capacity is the world size, so it never needs to grow.
+    // Both walls arrays point into [map] while a shared map is attached.
     snaken_world_size_t* walls;
 
+    // Position of every cell in the walls array, [SNAKEN_NO_WALL] if the cell holds no wall.
+    snaken_world_size_t* walls_index;
+
+    // Shared map the walls belong to, NULL if the walls are owned by the snaken.
+    // Walls of a shared map are never modified: the snaken copies them first.
+    snaken2d_map_t* map;
+
     // ################
     // ################
 
@@ -119,7 +281,7 @@ typedef struct {
     // Apples array length.
     snaken_world_size_t apples_length;
 
-    // Apples array.
+    // Apples array. Apples spawn off walls, off the snake head and off each other, unless the world is too crowded.
     snaken_world_size_t* apples;
 
     // Total amount of apples eaten by the snake.
@@ -177,6 +339,58 @@ typedef struct {
 
     // ################
     // ################
+
+
+    // ################
+    // Randomness.
+    // ################
+
+    // Generator of apple locations, seeded from rand() on init or explicitly by [snaken2d_reset].
+    snaken_rng_t rng;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Apple distance field.
+    // ################
+
+    // Distance of every cell from the nearest reachable apple, NULL if distance tracking is disabled.
+    snaken_world_size_t* apple_dist;
+
+    // Direction of the neighbor every cell distance was propagated from, 0xFF for apples and unreachable cells.
+    uint8_t* apple_dist_parents;
+
+    // Number of elements blocking every cell: walls, plus body sections if the snake cannot self intersect.
+    snaken_world_size_t* apple_dist_blocks;
+
+    // Number of apples on every cell.
+    snaken_world_size_t* apple_dist_apples;
+
+    // Scratch list of the cells invalidated by a distance increase.
+    snaken_world_size_t* apple_dist_stale;
+
+    // Scratch circular queue of the cells whose distance decreased.
+    snaken_world_size_t* apple_dist_queue;
+
+    // Whether every cell is currently in the scratch queue.
+    uint8_t* apple_dist_queued;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Events.
+    // ################
+
+    // Ring every tick and reset records its changes to, NULL if events are disabled.
+    // The ring is owned by the caller.
+    snaken_event_ring_t* events;
+
+    // ################
+    // ################
 } snaken2d_t;
 
 
@@ -202,6 +416,16 @@ snaken_error_code_t snaken2d_destroy(
     snaken2d_t* snaken
 );
 
+/// @brief Starts a new episode in place, keeping the world configuration (walls, apples count, speed, stamina and so on).
+/// The snake is restored to its starting state and apples are respawned from the provided seed, without reallocating the world.
+/// @param snaken The snaken to reset.
+/// @param seed The seed of the new episode. The same seed on the same configuration always yields the same episode.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_reset(
+    snaken2d_t* snaken,
+    uint64_t seed
+);
+
 // ##########################################
 // ##########################################
 
@@ -211,6 +435,8 @@ snaken_error_code_t snaken2d_destroy(
 // ##########################################
 
 /// @brief Performs a single run cycle in the provided snaken.
+/// If an event ring is set, every tick of a live snake records exactly one event to it, even if nothing changed,
+/// so that consumers can count ticks.
 /// @param snaken The snaken to run the loop in.
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
 snaken_error_code_t snaken2d_tick(
@@ -234,6 +460,164 @@ snaken_error_code_t snaken2d_get_snake_view(
     snaken_cell_type_t* view
 );
 
+/// @brief Casts [SNAKEN_RAYS_COUNT] rays around the snake head, relative to its direction, and stores the distance to the nearest wall, apple and body section along each.
+/// @param snaken The snaken to cast rays in.
+/// @param max_dist The maximum distance (in cells) each ray travels, wrapping around the world.
+/// @param rays The distances to populate, [SNAKEN_RAY_TARGETS_COUNT] per ray indexed by [snaken_ray_target_t]. 0 means nothing was found within [max_dist].
+/// Rays go front, front-left, left, back-left, back, back-right, right and front-right.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_get_rays(
+    snaken2d_t* snaken,
+    snaken_world_size_t max_dist,
+    snaken_world_size_t* rays
+);
+
+/// @brief Retrieves the length of the shortest path from the snake head to the nearest reachable apple, in O(1).
+/// @param snaken The snaken to query.
+/// @param dist The resulting distance, [SNAKEN_DIST_UNREACHABLE] if no apple can be reached or the snake is dead.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none, [SNAKEN_ERROR_FEATURE_DISABLED] if distance tracking is disabled.
+snaken_error_code_t snaken2d_get_apple_dist(
+    snaken2d_t* snaken,
+    snaken_world_size_t* dist
+);
+
+/// @brief Computes the memory layout of a batched observation tensor for the given view radius.
+/// @param layout The layout to populate.
+/// @param view_radius The radius of the view of every world in the batch.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_obs_layout_init(
+    snaken_obs_layout_t* layout,
+    snaken_world_size_t view_radius
+);
+
+/// @brief Allocates aligned views ([N][C][D][D]) and features ([N][F]) buffers for a batch of [count] worlds.
+/// @param layout The layout of the batch, as computed by [snaken_obs_layout_init].
+/// @param count The number of worlds in the batch.
+/// @param views The allocated views buffer. Must be freed with free().
+/// @param features The allocated features buffer. Must be freed with free().
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_obs_batch_alloc(
+    snaken_obs_layout_t* layout,
+    snaken_world_size_t count,
+    snaken_obs_t** views,
+    snaken_obs_t** features
+);
+
+/// @brief Writes the egocentric view and scalar features of a single world, laid out as one row of a batch.
+/// Unlike [snaken2d_get_obs_batch], it never allocates nor spawns threads, so it suits callers running their own workers.
+/// @param snaken The world to extract the observation from.
+/// @param layout The layout of the batch, as computed by [snaken_obs_layout_init].
+/// @param scratch Scratch space of at least [view_diameter * view_diameter] cells.
+/// @param view The [C][D][D] view row, one-hot encoded over [SNAKEN_OBS_CHANNELS] channels.
+/// @param feature The [F] features row: length, stamina step, direction and eaten apples count.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// @warning Dead snakes produce all-zero views and features.
+snaken_error_code_t snaken2d_get_obs(
+    snaken2d_t* snaken,
+    snaken_obs_layout_t* layout,
+    snaken_cell_type_t* scratch,
+    snaken_obs_t* view,
+    snaken_obs_t* feature
+);
+
+/// @brief Writes the egocentric views and scalar features of [count] worlds into a single contiguous tensor.
+/// @param snakens The worlds to extract observations from.
+/// @param count The number of worlds.
+/// @param layout The layout of the batch, as computed by [snaken_obs_layout_init].
+/// @param views The [N][C][D][D] views buffer, one-hot encoded over [SNAKEN_OBS_CHANNELS] channels.
+/// @param features The [N][F] features buffer: length, stamina step, direction and eaten apples count.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// @warning Dead snakes produce all-zero views and features.
+snaken_error_code_t snaken2d_get_obs_batch(
+    snaken2d_t** snakens,
+    snaken_world_size_t count,
+    snaken_obs_layout_t* layout,
+    snaken_obs_t* views,
+    snaken_obs_t* features
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Rendering functions.
+// ##########################################
+
+/// @brief Fills the provided palette with the default colors, the same ones used by the examples.
+/// @param palette The palette to fill.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_palette_init(snaken_palette_t* palette);
+
+/// @brief Rasterizes walls, apples and snake into an RGB frame, every cell being a [scale] x [scale] square.
+/// Runs on the CPU only, so it needs neither a window nor a GPU context.
+/// @param snaken The world to render.
+/// @param scale The side of every cell in pixels.
+/// @param palette The colors to render with, NULL for the default ones.
+/// @param out The frame to write, [world_height * scale] rows of [world_width * scale] pixels of [SNAKEN_RGB_CHANNELS] bytes each.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none, [SNAKEN_ERROR_INVALID_SIZE] if scale is not positive.
+/// @warning Dead snakes are not rendered.
+snaken_error_code_t snaken2d_render_rgb(
+    snaken2d_t* snaken,
+    snaken_world_size_t scale,
+    snaken_palette_t* palette,
+    uint8_t* out
+);
+
+/// @brief Rasterizes [count] worlds of the same size into consecutive frames of a single buffer, in parallel.
+/// @param snakens The worlds to render.
+/// @param count The number of worlds.
+/// @param scale The side of every cell in pixels.
+/// @param palette The colors to render with, NULL for the default ones.
+/// @param out The [N][H][W][SNAKEN_RGB_CHANNELS] frames buffer, as laid out by [snaken2d_render_rgb] for every world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none,
+/// [SNAKEN_ERROR_INVALID_SIZE] if scale is not positive or worlds differ in size.
+snaken_error_code_t snaken2d_render_rgb_batch(
+    snaken2d_t** snakens,
+    snaken_world_size_t count,
+    snaken_world_size_t scale,
+    snaken_palette_t* palette,
+    uint8_t* out
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Event functions.
+// ##########################################
+
+/// @brief Initializes the provided event ring on the provided storage.
+/// @param ring The ring to initialize.
+/// @param events The storage for the ring events, owned by the caller and kept alive as long as the ring is used.
+/// @param capacity The number of events fitting in the storage, a power of two.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none,
+/// [SNAKEN_ERROR_INVALID_SIZE] if the capacity is not a power of two.
+snaken_error_code_t snaken_event_ring_init(
+    snaken_event_ring_t* ring,
+    snaken_event_t* events,
+    uint32_t capacity
+);
+
+/// @brief Reads the oldest unread event from the provided ring. Must only be called by a single consumer at a time.
+/// @param ring The ring to read from.
+/// @param event The read event, left untouched if the ring is empty.
+/// @param result Whether an event was read.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_event_ring_pop(
+    snaken_event_ring_t* ring,
+    snaken_event_t* event,
+    snaken_bool_t* result
+);
+
+/// @brief Returns the number of events dropped by the provided ring because it was full.
+/// Consumers noticing it change have missed changes, so they need to read the world as a whole again.
+/// @param ring The ring to read from.
+/// @param result The number of dropped events.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken_event_ring_get_dropped_count(snaken_event_ring_t* ring, uint32_t* result);
+
 // ##########################################
 // ##########################################
 
@@ -269,6 +653,24 @@ snaken_error_code_t snaken2d_set_snake_length(
     snaken_world_size_t length
 );
 
+/// @brief Enables or disables tracking of the distance from every cell to the nearest reachable apple.
+/// Paths wrap around the world and are blocked by walls, as well as by the snake body if the snake cannot self intersect.
+/// While enabled, the distance field is updated incrementally as apples are spawned or eaten and the snake moves.
+/// @param snaken The snaken to apply changes to.
+/// @param enabled Whether distance tracking should be enabled or not.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_set_apple_dist_tracking(
+    snaken2d_t* snaken,
+    snaken_bool_t enabled
+);
+
+/// @brief Sets the ring the provided snaken records its changes to.
+/// Only ticks and resets are recorded: changes made through any other setter require consumers to read the world as a whole again.
+/// @param snaken The snaken to apply changes to.
+/// @param ring The ring to record changes to, NULL to stop recording.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_set_event_ring(snaken2d_t* snaken, snaken_event_ring_t* ring);
+
 /// @brief Turns the snake left relative to its current direction.
 /// @param snaken The snaken to apply the turn to.
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
@@ -279,6 +681,12 @@ snaken_error_code_t snaken2d_turn_left(snaken2d_t* snaken);
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
 snaken_error_code_t snaken2d_turn_right(snaken2d_t* snaken);
 
+/// @brief Applies the provided action to the snake, relative to its current direction.
+/// @param snaken The snaken to apply the action to.
+/// @param action The action to apply, see [snaken_action_t]. Unknown actions keep the snake going straight.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_apply_action(snaken2d_t* snaken, uint8_t action);
+
 /// @brief Sets whether the snake can self-intersect without dying or not.
 /// @param snaken The snaken to apply changes to.
 /// @param val The value to apply.
@@ -304,28 +712,182 @@ snaken_error_code_t snaken2d_set_snake_stamina(snaken2d_t* snaken, snaken_snake_
 snaken_error_code_t snaken2d_set_apples_count(snaken2d_t* snaken, snaken_world_size_t apples_count);
 
 /// @brief Updates the location of the apple at the provided index while avoiding putting it on walls.
+/// The apple is left in place if walls cover the whole world.
 /// @param snaken The snaken to apply changes to.
 /// @param index The index of the apple to update.
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
 snaken_error_code_t snaken2d_spawn_apple(snaken2d_t* snaken, snaken_world_size_t index);
 
-/// @brief Applies the provided walls to the provided snaken's world.
+/// @brief Applies the provided walls to the provided snaken's world. Duplicate walls are only stored once.
 /// @param snaken The snaken to apply walls to.
 /// @param walls_length The length of the walls array.
-/// @param walls The array of walls.
+/// @param walls The array of walls, freed once applied.
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any wall lies outside the world, in which case nothing is changed and [walls] is not freed.
 /// @warning The provided walls will overwrite any existing walls. Use [snaken2d_add_walls] to add them instead.
 snaken_error_code_t snaken2d_set_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls);
 
 
-/// @brief Adds the provided walls to the existing walls in the provided snaken's world.
+/// @brief Adds the provided walls to the existing walls in the provided snaken's world. Walls already present are skipped.
 /// @param snaken The snaken to apply walls to.
 /// @param walls_length The length of the walls array to add.
-/// @param walls The array of walls to add.
+/// @param walls The array of walls to add, left untouched.
 /// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any wall lies outside the world, in which case nothing is changed.
 /// @warning The provided walls will not overwrite any existing walls. Use [snaken2d_set_walls] to overwrite them instead.
 snaken_error_code_t snaken2d_add_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls);
 
+/// @brief Removes the provided walls from the provided snaken's world. Walls not present are skipped.
+/// @param snaken The snaken to remove walls from.
+/// @param walls_length The length of the walls array to remove.
+/// @param walls The array of walls to remove, left untouched.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if any wall lies outside the world, in which case nothing is changed.
+snaken_error_code_t snaken2d_remove_walls(snaken2d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls);
+
+/// @brief Puts a wall on every cell of the provided rectangle, in O(rectangle area).
+/// @param snaken The snaken to apply walls to.
+/// @param x The x location of the top left corner of the rectangle.
+/// @param y The y location of the top left corner of the rectangle.
+/// @param width The width of the rectangle.
+/// @param height The height of the rectangle.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if the rectangle does not fit in the world, in which case nothing is changed.
+snaken_error_code_t snaken2d_fill_walls_rect(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+);
+
+/// @brief Removes any wall from every cell of the provided rectangle, in O(rectangle area).
+/// @param snaken The snaken to remove walls from.
+/// @param x The x location of the top left corner of the rectangle.
+/// @param y The y location of the top left corner of the rectangle.
+/// @param width The width of the rectangle.
+/// @param height The height of the rectangle.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if the rectangle does not fit in the world, in which case nothing is changed.
+snaken_error_code_t snaken2d_clear_walls_rect(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height
+);
+
+/// @brief Puts or removes walls on the cells of the provided rectangle selected by [mask], in O(rectangle area).
+/// @param snaken The snaken to update walls in.
+/// @param x The x location of the top left corner of the rectangle.
+/// @param y The y location of the top left corner of the rectangle.
+/// @param width The width of the rectangle.
+/// @param height The height of the rectangle.
+/// @param mask The [width] by [height] row-major mask, whose nonzero cells get updated.
+/// @param val Whether to put walls on the selected cells rather than removing them.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if the rectangle does not fit in the world, in which case nothing is changed.
+snaken_error_code_t snaken2d_update_walls_mask(
+    snaken2d_t* snaken,
+    snaken_world_size_t x,
+    snaken_world_size_t y,
+    snaken_world_size_t width,
+    snaken_world_size_t height,
+    uint8_t* mask,
+    snaken_bool_t val
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Map generation functions.
+// ##########################################
+// Generators replace all walls in place and are reproducible: the same seed on the same world size always yields the same map.
+// Once generated, cells under the snake are freed from walls and apples lying on walls are moved elsewhere.
+
+/// @brief Generates a map of random rectangular rooms, carved out of solid walls and connected in sequence by corridors.
+/// @param snaken The snaken to generate the map in.
+/// @param seed The seed of the map.
+/// @param rooms_count The number of rooms to carve.
+/// @param min_room_size The minimum width and height of every room.
+/// @param max_room_size The maximum width and height of every room, not larger than the world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_generate_rooms(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    snaken_world_size_t rooms_count,
+    snaken_world_size_t min_room_size,
+    snaken_world_size_t max_room_size
+);
+
+/// @brief Generates a perfect maze, whose corridors lie on odd coordinates and are one cell wide.
+/// @param snaken The snaken to generate the map in.
+/// @param seed The seed of the map.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_generate_maze(
+    snaken2d_t* snaken,
+    uint64_t seed
+);
+
+/// @brief Generates randomly scattered single-cell obstacles.
+/// @param snaken The snaken to generate the map in.
+/// @param seed The seed of the map.
+/// @param density The probability of every cell to hold a wall, in [0, 1].
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_generate_obstacles(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    float density
+);
+
+/// @brief Generates caves by smoothing random obstacles with a cellular automaton.
+/// @param snaken The snaken to generate the map in.
+/// @param seed The seed of the map.
+/// @param density The initial probability of every cell to hold a wall, in [0, 1]. Values around 0.45 yield open caves.
+/// @param iterations The number of smoothing iterations.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_generate_caves(
+    snaken2d_t* snaken,
+    uint64_t seed,
+    float density,
+    snaken_world_size_t iterations
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Shared map functions.
+// ##########################################
+
+/// @brief Creates a shared map holding a copy of the walls of the provided snaken, with one reference owned by the caller.
+/// @param map The map to create.
+/// @param snaken The snaken to copy the walls of.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_map_create(snaken2d_map_t** map, snaken2d_t* snaken);
+
+/// @brief Releases one reference to the provided map, destroying it once no references are left.
+/// @param map The map to release.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_map_release(snaken2d_map_t* map);
+
+/// @brief Replaces the walls of the provided snaken with the provided shared map, freeing its own walls.
+/// Apples lying on the map walls are moved elsewhere. Attaching is thread safe, so worlds can attach to a map concurrently.
+/// @param snaken The snaken to attach the map to.
+/// @param map The map to attach.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+/// [SNAKEN_ERROR_INDEX_OUT_OF_RANGE] if the map size does not match the world size.
+snaken_error_code_t snaken2d_attach_map(snaken2d_t* snaken, snaken2d_map_t* map);
+
+/// @brief Detaches the provided snaken from its shared map, if any, giving it its own copy of the map walls.
+/// Any wall update on a snaken attached to a map detaches it first, so this is only needed to release the map early.
+/// @param snaken The snaken to detach.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken2d_detach_map(snaken2d_t* snaken);
+
 // ##########################################
 // ##########################################
 
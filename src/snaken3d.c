@@ -0,0 +1,633 @@
+#include "snaken3d.h"
+
+// ##########################################
+// Geometry functions.
+// ##########################################
+
+/// @brief Computes the world-space unit vector of the provided direction.
+/// @param direction The direction to compute the vector of.
+/// @param vector The resulting x, y and z components.
+static void snaken_dir3d_vector(
+    snaken_dir3d_t direction,
+    snaken_world_size_t* vector
+) {
+    vector[0] = 0;
+    vector[1] = 0;
+    vector[2] = 0;
+
+    // Directions come in opposite pairs along each axis, positive first.
+    vector[direction / 2] = direction % 2 ? -1 : 1;
+}
+
+/// @brief Computes the direction of the provided axis-aligned unit vector.
+/// @param vector The x, y and z components of the vector.
+/// @return The direction of the vector.
+static snaken_dir3d_t snaken_dir3d_from_vector(
+    snaken_world_size_t* vector
+) {
+    for (snaken_world_size_t axis = 0; axis < 3; axis++) {
+        if (vector[axis] != 0) return (snaken_dir3d_t) (axis * 2 + (vector[axis] < 0 ? 1 : 0));
+    }
+
+    return SNAKEN_STARTING_SNAKE_DIR_3D;
+}
+
+/// @brief Computes the direction opposite to the provided one.
+/// @param direction The direction to compute the opposite of.
+/// @return The opposite direction.
+static snaken_dir3d_t snaken_dir3d_opposite(
+    snaken_dir3d_t direction
+) {
+    return (snaken_dir3d_t) (direction ^ 0x01);
+}
+
+/// @brief Computes the direction to the right of a snake facing [direction] with its roof facing [roof].
+/// @param direction The snake facing direction.
+/// @param roof The snake roof direction.
+/// @return The snake right direction.
+static snaken_dir3d_t snaken_dir3d_right(
+    snaken_dir3d_t direction,
+    snaken_dir3d_t roof
+) {
+    snaken_world_size_t front_vector[3];
+    snaken_world_size_t roof_vector[3];
+    snaken_dir3d_vector(direction, front_vector);
+    snaken_dir3d_vector(roof, roof_vector);
+
+    // Right is front x roof, so that front, up and right match the default orientation (front z, up -y, right x).
+    snaken_world_size_t right_vector[3] = {
+        front_vector[1] * roof_vector[2] - front_vector[2] * roof_vector[1],
+        front_vector[2] * roof_vector[0] - front_vector[0] * roof_vector[2],
+        front_vector[0] * roof_vector[1] - front_vector[1] * roof_vector[0]
+    };
+
+    return snaken_dir3d_from_vector(right_vector);
+}
+
+/// @brief Computes the location reached by moving from [location] by the provided offset, wrapping around the world.
+/// @param snaken The snaken the location belongs to.
+/// @param location The starting location.
+/// @param offset The x, y and z components of the offset.
+/// @return The reached location.
+static snaken_world_size_t snaken3d_offset_location(
+    snaken3d_t* snaken,
+    snaken_world_size_t location,
+    snaken_world_size_t* offset
+) {
+    snaken_world_size_t x = location % snaken->world_width;
+    snaken_world_size_t y = (location / snaken->world_width) % snaken->world_height;
+    snaken_world_size_t z = location / (snaken->world_width * snaken->world_height);
+
+    return IDX3D(
+        WRAP(x + offset[0], snaken->world_width),
+        WRAP(y + offset[1], snaken->world_height),
+        WRAP(z + offset[2], snaken->world_depth),
+        snaken->world_width,
+        snaken->world_height
+    );
+}
+
+/// @brief Checks whether the provided location is free from walls and apples.
+/// @param snaken The snaken the location belongs to.
+/// @param location The location to check.
+/// @return Whether the location is free.
+static snaken_bool_t snaken3d_is_free(
+    snaken3d_t* snaken,
+    snaken_world_size_t location
+) {
+    return !snaken->walls_map[location] && snaken->apples_map[location] < 0;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Snake body functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided body section.
+/// @param snaken The snaken to read the section from.
+/// @param section The index of the section, 0 being the head.
+/// @return The section location.
+static snaken_world_size_t snaken3d_section(
+    snaken3d_t* snaken,
+    snaken_world_size_t section
+) {
+    return snaken->snake_body[(snaken->snake_body_head + section) % snaken->snake_body_capacity];
+}
+
+/// @brief Makes sure the snake body can hold at least [capacity] sections, laying sections out again from the head if needed.
+/// @param snaken The snaken to grow the body of.
+/// @param capacity The minimum capacity.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken3d_reserve_body(
+    snaken3d_t* snaken,
+    snaken_world_size_t capacity
+) {
+    if (capacity <= snaken->snake_body_capacity) return SNAKEN_ERROR_NONE;
+
+    // Grow geometrically, so that growing one section at a time is amortized.
+    snaken_world_size_t new_capacity = snaken->snake_body_capacity * 2;
+    if (new_capacity < capacity) new_capacity = capacity;
+
+    snaken_world_size_t* new_body = (snaken_world_size_t*) malloc(new_capacity * sizeof(snaken_world_size_t));
+    if (new_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    for (snaken_world_size_t i = 0; i < snaken->snake_length; i++) {
+        new_body[i] = snaken3d_section(snaken, i);
+    }
+
+    free(snaken->snake_body);
+    snaken->snake_body = new_body;
+    snaken->snake_body_capacity = new_capacity;
+    snaken->snake_body_head = 0;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Appends a new body section on the tail.
+/// @param snaken The snaken to grow the snake of.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+static snaken_error_code_t snaken3d_append_section(
+    snaken3d_t* snaken
+) {
+    snaken_error_code_t error = snaken3d_reserve_body(snaken, snaken->snake_length + 1);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+
+    snaken_world_size_t tail = snaken3d_section(snaken, snaken->snake_length - 1);
+    snaken->snake_body[(snaken->snake_body_head + snaken->snake_length) % snaken->snake_body_capacity] = tail;
+    snaken->snake_occupancy[tail]++;
+    snaken->snake_length++;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+/// @brief Removes the tail body section.
+/// @param snaken The snaken to shrink the snake of.
+static void snaken3d_remove_section(
+    snaken3d_t* snaken
+) {
+    snaken->snake_occupancy[snaken3d_section(snaken, snaken->snake_length - 1)]--;
+    snaken->snake_length--;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+snaken_error_code_t snaken3d_init(
+    snaken3d_t** snaken,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t world_depth
+) {
+    snaken_world_size_t world_size = world_width * world_height * world_depth;
+
+    // Allocate the snaken.
+    (*snaken) = (snaken3d_t*) malloc(sizeof(snaken3d_t));
+    if ((*snaken) == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // Store world size.
+    (*snaken)->world_width = world_width;
+    (*snaken)->world_height = world_height;
+    (*snaken)->world_depth = world_depth;
+
+    // Allocate grids.
+    (*snaken)->walls_map = (uint8_t*) calloc(world_size, sizeof(uint8_t));
+    (*snaken)->apples_map = (snaken_world_size_t*) malloc(world_size * sizeof(snaken_world_size_t));
+    (*snaken)->snake_occupancy = (snaken_world_size_t*) calloc(world_size, sizeof(snaken_world_size_t));
+    if ((*snaken)->walls_map == NULL || (*snaken)->apples_map == NULL || (*snaken)->snake_occupancy == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    for (snaken_world_size_t i = 0; i < world_size; i++) {
+        (*snaken)->apples_map[i] = -1;
+    }
+
+    // Allocate walls.
+    (*snaken)->walls_length = 0;
+    (*snaken)->walls = NULL;
+
+    // Allocate snake body.
+    (*snaken)->snake_length = SNAKEN_STARTING_SNAKE_LENGTH;
+    (*snaken)->snake_body_capacity = SNAKEN_STARTING_SNAKE_LENGTH;
+    (*snaken)->snake_body_head = 0;
+    (*snaken)->snake_body = (snaken_world_size_t*) malloc((*snaken)->snake_body_capacity * sizeof(snaken_world_size_t));
+    if ((*snaken)->snake_body == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+
+    // The whole body starts in the starting hole, under the head.
+    snaken_world_size_t start = IDX3D(world_width / 2, world_height / 2, world_depth / 2, world_width, world_height);
+    for (snaken_world_size_t i = 0; i < (*snaken)->snake_length; i++) {
+        (*snaken)->snake_body[i] = start;
+    }
+    (*snaken)->snake_occupancy[start] = (*snaken)->snake_length;
+
+    (*snaken)->snake_speed = SNAKEN_DEFAULT_SNAKE_SPEED;
+    (*snaken)->snake_speed_step = 0;
+    (*snaken)->snake_stamina = SNAKEN_DEFAULT_SNAKE_STAMINA;
+    (*snaken)->snake_stamina_step = 0;
+    (*snaken)->snake_direction = SNAKEN_STARTING_SNAKE_DIR_3D;
+    (*snaken)->snake_roof = SNAKEN_STARTING_SNAKE_ROOF_3D;
+    (*snaken)->self_intersects = SNAKEN_TRUE;
+    (*snaken)->snake_alive = SNAKEN_TRUE;
+    (*snaken)->snake_view_radius = SNAKEN_DEFAULT_SNAKE_VIEW_RADIUS;
+
+    // Allocate and populate apples.
+    (*snaken)->eaten_apples_count = 0;
+    (*snaken)->apples_length = 0;
+    (*snaken)->apples = NULL;
+    (*snaken)->rng = ((uint64_t) rand() << 32) ^ (uint64_t) rand();
+
+    return snaken3d_set_apples_count(*snaken, SNAKEN_DEFAULT_APPLES_LENGTH);
+}
+
+snaken_error_code_t snaken3d_destroy(
+    snaken3d_t* snaken
+) {
+    free(snaken->snake_body);
+    free(snaken->snake_occupancy);
+    free(snaken->walls);
+    free(snaken->walls_map);
+    free(snaken->apples);
+    free(snaken->apples_map);
+    free(snaken);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+snaken_error_code_t snaken3d_tick(snaken3d_t* snaken) {
+    snaken_error_code_t error = SNAKEN_ERROR_NONE;
+
+    if (!snaken->snake_alive) return SNAKEN_ERROR_NONE;
+
+    // 1: Move the snake along its facing direction.
+    snaken->snake_speed_step++;
+    if (snaken->snake_speed_step >= (snaken_snake_speed_t) (~snaken->snake_speed)) {
+        snaken->snake_speed_step = 0;
+
+        snaken_world_size_t direction_vector[3];
+        snaken_dir3d_vector(snaken->snake_direction, direction_vector);
+        snaken_world_size_t head = snaken3d_offset_location(snaken, snaken3d_section(snaken, 0), direction_vector);
+
+        // Release the tail before moving the head backwards in the ring, since it could overwrite it.
+        snaken->snake_occupancy[snaken3d_section(snaken, snaken->snake_length - 1)]--;
+        snaken->snake_body_head = (snaken->snake_body_head + snaken->snake_body_capacity - 1) % snaken->snake_body_capacity;
+        snaken->snake_body[snaken->snake_body_head] = head;
+        snaken->snake_occupancy[head]++;
+    }
+
+    snaken_world_size_t head = snaken3d_section(snaken, 0);
+
+    // 2: Let the snake eat any apple in its way.
+    snaken_world_size_t apple = snaken->apples_map[head];
+    if (apple >= 0) {
+        snaken->eaten_apples_count++;
+        snaken->snake_stamina_step = 0;
+
+        error = snaken3d_spawn_apple(snaken, apple);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+
+        // If any apple was found, then no wall can, so just end here.
+        return snaken3d_append_section(snaken);
+    }
+
+    // 3: Check for walls.
+    if (snaken->walls_map[head]) {
+        snaken->snake_alive = SNAKEN_FALSE;
+        return SNAKEN_ERROR_NONE;
+    }
+
+    // 4: Check for body if so specified: any section other than the head on the head cell is hit.
+    if (snaken->self_intersects == SNAKEN_FALSE && snaken->snake_occupancy[head] > 1) {
+        snaken->snake_alive = SNAKEN_FALSE;
+    }
+
+    // 5: Check for hunger.
+    snaken->snake_stamina_step++;
+    if (snaken->snake_stamina_step <= snaken->snake_stamina) return SNAKEN_ERROR_NONE;
+
+    // Reset hunger and chop the snake body off by one.
+    snaken->snake_stamina_step = 0;
+    snaken3d_remove_section(snaken);
+
+    // Let the snake die of hunger.
+    if (snaken->snake_length <= 0) snaken->snake_alive = SNAKEN_FALSE;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+snaken_error_code_t snaken3d_get_snake_section(
+    snaken3d_t* snaken,
+    snaken_world_size_t section,
+    snaken_world_size_t* location
+) {
+    if (section < 0 || section >= snaken->snake_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    (*location) = snaken3d_section(snaken, section);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_get_snake_view(
+    snaken3d_t* snaken,
+    snaken_cell_type_t* view
+) {
+    if (snaken->snake_length <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    snaken_world_size_t radius = snaken->snake_view_radius;
+    snaken_world_size_t snake_view_diameter = NH_DIAM_2D(radius);
+    snaken_world_size_t head = snaken3d_section(snaken, 0);
+
+    // Build the snake local frame.
+    snaken_world_size_t right_vector[3];
+    snaken_world_size_t roof_vector[3];
+    snaken_world_size_t front_vector[3];
+    snaken_dir3d_vector(snaken_dir3d_right(snaken->snake_direction, snaken->snake_roof), right_vector);
+    snaken_dir3d_vector(snaken->snake_roof, roof_vector);
+    snaken_dir3d_vector(snaken->snake_direction, front_vector);
+
+    for (snaken_world_size_t z = 0; z < snake_view_diameter; z++) {
+        for (snaken_world_size_t y = 0; y < snake_view_diameter; y++) {
+            for (snaken_world_size_t x = 0; x < snake_view_diameter; x++) {
+                snaken_world_size_t offset[3];
+                for (snaken_world_size_t axis = 0; axis < 3; axis++) {
+                    offset[axis] = (x - radius) * right_vector[axis] + (y - radius) * roof_vector[axis] + (z - radius) * front_vector[axis];
+                }
+
+                snaken_world_size_t location = snaken3d_offset_location(snaken, head, offset);
+                snaken_cell_type_t* cell = &(view[IDX3D(x, y, z, snake_view_diameter, snake_view_diameter)]);
+
+                // Every lookup is a single grid access, regardless of the number of walls, apples and body sections.
+                if (location == head) {
+                    (*cell) = SNAKEN_SNAKE_HEAD;
+                } else if (snaken->snake_occupancy[location] > 0) {
+                    (*cell) = SNAKEN_SNAKE_BODY;
+                } else if (snaken->apples_map[location] >= 0) {
+                    (*cell) = SNAKEN_APPLE;
+                } else if (snaken->walls_map[location]) {
+                    (*cell) = SNAKEN_WALL;
+                } else {
+                    (*cell) = SNAKEN_EMPTY;
+                }
+            }
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+snaken_error_code_t snaken3d_set_snake_dir(snaken3d_t* snaken, snaken_dir3d_t direction) {
+    if (direction > SNAKEN_3D_BACK) {
+        return SNAKEN_ERROR_INVALID_DIRECTION;
+    }
+
+    // Pitch the roof along if the new direction is vertical relative to the snake.
+    if (direction == snaken->snake_roof) {
+        snaken->snake_roof = snaken_dir3d_opposite(snaken->snake_direction);
+    } else if (direction == snaken_dir3d_opposite(snaken->snake_roof)) {
+        snaken->snake_roof = snaken->snake_direction;
+    }
+
+    snaken->snake_direction = direction;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_turn_left(snaken3d_t* snaken) {
+    snaken->snake_direction = snaken_dir3d_opposite(snaken_dir3d_right(snaken->snake_direction, snaken->snake_roof));
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_turn_right(snaken3d_t* snaken) {
+    snaken->snake_direction = snaken_dir3d_right(snaken->snake_direction, snaken->snake_roof);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_turn_up(snaken3d_t* snaken) {
+    snaken_dir3d_t direction = snaken->snake_direction;
+
+    snaken->snake_direction = snaken->snake_roof;
+    snaken->snake_roof = snaken_dir3d_opposite(direction);
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_turn_down(snaken3d_t* snaken) {
+    snaken_dir3d_t direction = snaken->snake_direction;
+
+    snaken->snake_direction = snaken_dir3d_opposite(snaken->snake_roof);
+    snaken->snake_roof = direction;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_snake_view_radius(snaken3d_t* snaken, snaken_world_size_t radius) {
+    snaken->snake_view_radius = radius;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_snake_length(snaken3d_t* snaken, snaken_world_size_t length) {
+    if (length <= 0) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    while (snaken->snake_length > length) {
+        snaken3d_remove_section(snaken);
+    }
+
+    // Place the new body pieces exactly on the existing tail.
+    snaken_error_code_t error = snaken3d_reserve_body(snaken, length);
+    if (error != SNAKEN_ERROR_NONE) {
+        return error;
+    }
+    while (snaken->snake_length < length) {
+        error = snaken3d_append_section(snaken);
+        if (error != SNAKEN_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_self_intersect(snaken3d_t* snaken, snaken_bool_t val) {
+    snaken->self_intersects = val;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_snake_speed(snaken3d_t* snaken, snaken_snake_speed_t speed) {
+    snaken->snake_speed = speed;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_snake_stamina(snaken3d_t* snaken, snaken_snake_stamina_t stamina) {
+    snaken->snake_stamina = stamina;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_seed(snaken3d_t* snaken, uint64_t seed) {
+    snaken->rng = seed;
+
+    // Release all apples first, so that respawned ones only avoid each other in spawn order.
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        if (snaken->apples[i] >= 0) snaken->apples_map[snaken->apples[i]] = -1;
+        snaken->apples[i] = -1;
+    }
+    for (snaken_world_size_t i = 0; i < snaken->apples_length; i++) {
+        snaken3d_spawn_apple(snaken, i);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_set_apples_count(snaken3d_t* snaken, snaken_world_size_t apples_count) {
+    // Save the old count for later use.
+    snaken_world_size_t old_apples_count = snaken->apples_length;
+
+    // If the amount of apples decreased, then remove the exceeding ones.
+    for (snaken_world_size_t i = apples_count; i < old_apples_count; i++) {
+        if (snaken->apples[i] >= 0) snaken->apples_map[snaken->apples[i]] = -1;
+    }
+
+    // Resize the apples array.
+    snaken_world_size_t* apples = (snaken_world_size_t*) realloc(snaken->apples, apples_count * sizeof(snaken_world_size_t));
+    if (apples_count > 0 && apples == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->apples = apples;
+    snaken->apples_length = apples_count;
+
+    // If the amount of apples increased, then spawn new ones.
+    for (snaken_world_size_t i = old_apples_count; i < snaken->apples_length; i++) {
+        // Mark the slot as empty, so that spawning does not release any cell.
+        snaken->apples[i] = -1;
+        snaken3d_spawn_apple(snaken, i);
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_spawn_apple(snaken3d_t* snaken, snaken_world_size_t index) {
+    // Make sure the provided index is in range.
+    if (index < 0 || index >= snaken->apples_length) {
+        return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    // Release the current apple cell.
+    if (snaken->apples[index] >= 0 && snaken->apples_map[snaken->apples[index]] == index) {
+        snaken->apples_map[snaken->apples[index]] = -1;
+    }
+
+    snaken->apples[index] = -1;
+
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height * snaken->world_depth;
+    snaken_world_size_t apple_location = -1;
+
+    // Random picks find a free cell quickly unless the volume is crowded, so only try as many as there are cells.
+    for (snaken_world_size_t i = 0; i < world_size && apple_location < 0; i++) {
+        snaken_world_size_t location = IDX3D(
+            snaken_rng_range(&(snaken->rng), snaken->world_width),
+            snaken_rng_range(&(snaken->rng), snaken->world_height),
+            snaken_rng_range(&(snaken->rng), snaken->world_depth),
+            snaken->world_width,
+            snaken->world_height
+        );
+        if (snaken3d_is_free(snaken, location)) apple_location = location;
+    }
+
+    // Crowded volumes are scanned from a random cell instead, leaving the apple out if no cell is free.
+    snaken_world_size_t start = snaken_rng_range(&(snaken->rng), world_size);
+    for (snaken_world_size_t i = 0; i < world_size && apple_location < 0; i++) {
+        snaken_world_size_t location = (start + i) % world_size;
+        if (snaken3d_is_free(snaken, location)) apple_location = location;
+    }
+    if (apple_location < 0) return SNAKEN_ERROR_NONE;
+
+    snaken->apples[index] = apple_location;
+    snaken->apples_map[apple_location] = index;
+
+    return SNAKEN_ERROR_NONE;
+}
+
+snaken_error_code_t snaken3d_add_walls(snaken3d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls) {
+    snaken_world_size_t world_size = snaken->world_width * snaken->world_height * snaken->world_depth;
+
+    // Make sure all walls are in range before changing anything.
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        if (walls[i] < 0 || walls[i] >= world_size) {
+            return SNAKEN_ERROR_INDEX_OUT_OF_RANGE;
+        }
+    }
+
+    // Resize the walls array for the worst case, then shrink it back once duplicates are skipped.
+    snaken_world_size_t* new_walls = (snaken_world_size_t*) realloc(snaken->walls, (snaken->walls_length + walls_length) * sizeof(snaken_world_size_t));
+    if (snaken->walls_length + walls_length > 0 && new_walls == NULL) {
+        return SNAKEN_ERROR_FAILED_ALLOC;
+    }
+    snaken->walls = new_walls;
+
+    for (snaken_world_size_t i = 0; i < walls_length; i++) {
+        if (snaken->walls_map[walls[i]]) continue;
+
+        snaken->walls_map[walls[i]] = SNAKEN_TRUE;
+        snaken->walls[snaken->walls_length++] = walls[i];
+    }
+
+    if (snaken->walls_length > 0) {
+        new_walls = (snaken_world_size_t*) realloc(snaken->walls, snaken->walls_length * sizeof(snaken_world_size_t));
+        if (new_walls != NULL) snaken->walls = new_walls;
+    }
+
+    return SNAKEN_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
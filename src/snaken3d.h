@@ -0,0 +1,322 @@
+/*
+*****************************************************************
+snaken3d.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __SNAKEN_3D__
+#define __SNAKEN_3D__
+
+#include "snaken.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Computes the number of cells in a cubic neighborhood given its diameter, center included.
+#define NH_VOLUME_3D(d) ((d) * (d) * (d))
+
+typedef enum {
+    SNAKEN_3D_RIGHT = 0x00,
+    SNAKEN_3D_LEFT = 0x01,
+    SNAKEN_3D_DOWN = 0x02,
+    SNAKEN_3D_UP = 0x03,
+    SNAKEN_3D_FRONT = 0x04,
+    SNAKEN_3D_BACK = 0x05
+} snaken_dir3d_t;
+
+#define SNAKEN_STARTING_SNAKE_DIR_3D SNAKEN_3D_FRONT
+#define SNAKEN_STARTING_SNAKE_ROOF_3D SNAKEN_3D_UP
+
+typedef struct {
+    // ################
+    // World properties.
+    // ################
+
+    // World size.
+    snaken_world_size_t world_width;
+    snaken_world_size_t world_height;
+    snaken_world_size_t world_depth;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Walls locations.
+    // ################
+
+    // Length of walls array.
+    snaken_world_size_t walls_length;
+
+    // Walls array.
+    snaken_world_size_t* walls;
+
+    // Whether every cell holds a wall or not.
+    uint8_t* walls_map;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Apple locations.
+    // ################
+
+    // Apples array length.
+    snaken_world_size_t apples_length;
+
+    // Apples array, -1 for apples left out because no cell was free.
+    snaken_world_size_t* apples;
+
+    // Index of the apple held by every cell, -1 if none. Apples never share a cell.
+    snaken_world_size_t* apples_map;
+
+    // Total amount of apples eaten by the snake.
+    snaken_world_size_t eaten_apples_count;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Randomness.
+    // ################
+
+    // Generator of apple locations, seeded from rand() on init or explicitly by [snaken3d_set_seed].
+    snaken_rng_t rng;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snake locations.
+    // ################
+
+    // Snake length.
+    snaken_world_size_t snake_length;
+
+    // Capacity of the snake body buffer.
+    snaken_world_size_t snake_body_capacity;
+
+    // Index of the head in the snake body buffer.
+    snaken_world_size_t snake_body_head;
+
+    // Snake body, stored as a ring buffer starting at [snake_body_head], so that moving never shifts it.
+    snaken_world_size_t* snake_body;
+
+    // Number of snake sections (head included) on every cell.
+    snaken_world_size_t* snake_occupancy;
+
+    // ################
+    // ################
+
+
+    // ################
+    // Snake properties.
+    // ################
+
+    // Snake speed, see [snaken2d_t].
+    snaken_snake_speed_t snake_speed;
+
+    // Snake speed buildup, see [snaken2d_t].
+    snaken_snake_speed_t snake_speed_step;
+
+    // Snake stamina, see [snaken2d_t].
+    snaken_snake_stamina_t snake_stamina;
+
+    // Hunger buildup, see [snaken2d_t].
+    snaken_snake_stamina_t snake_stamina_step;
+
+    // The current snake direction.
+    snaken_dir3d_t snake_direction;
+
+    // The direction the top of the snake head faces, always perpendicular to [snake_direction].
+    snaken_dir3d_t snake_roof;
+
+    // Whether self intersection is enabled (can self intersect without dying) or not.
+    snaken_bool_t self_intersects;
+
+    // Tells whether the snake is currently alive or not.
+    snaken_bool_t snake_alive;
+
+    // Snake view radius.
+    snaken_world_size_t snake_view_radius;
+
+    // ################
+    // ################
+} snaken3d_t;
+
+
+// ##########################################
+// Initialization functions.
+// ##########################################
+
+/// @brief Initializes the given 3D snaken with default values.
+/// @param snaken The snaken to initialize.
+/// @param world_width The width (x size) of the snaken world.
+/// @param world_height The height (y size) of the snaken world.
+/// @param world_depth The depth (z size) of the snaken world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_init(
+    snaken3d_t** snaken,
+    snaken_world_size_t world_width,
+    snaken_world_size_t world_height,
+    snaken_world_size_t world_depth
+);
+
+/// @brief Destroys the given snaken and frees memory for it and its data.
+/// @param snaken The snaken to destroy.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_destroy(
+    snaken3d_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Execution functions.
+// ##########################################
+
+/// @brief Performs a single run cycle in the provided snaken.
+/// @param snaken The snaken to run the loop in.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_tick(
+    snaken3d_t* snaken
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Getter functions.
+// ##########################################
+
+/// @brief Retrieves the location of the provided snake body section.
+/// @param snaken The snaken to read the section from.
+/// @param section The index of the section, 0 being the head.
+/// @param location The resulting location.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_get_snake_section(
+    snaken3d_t* snaken,
+    snaken_world_size_t section,
+    snaken_world_size_t* location
+);
+
+/// @brief Retrieves the current cubic snake view and stores it in [view].
+/// The view is indexed as IDX3D(x, y, z, d, d), d being the view diameter, with the head at the center,
+/// x growing to the snake right, y growing towards the snake roof and z growing towards the snake front.
+/// @param snaken The snaken to extract the view from.
+/// @param view The view to populate, [NH_VOLUME_3D] of the view diameter long.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_get_snake_view(
+    snaken3d_t* snaken,
+    snaken_cell_type_t* view
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions.
+// ##########################################
+
+/// @brief Sets the snake facing direction, rolling the snake roof as little as possible.
+/// @param snaken The snaken to apply the snake direction to.
+/// @param direction The direction to set the snake to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_snake_dir(snaken3d_t* snaken, snaken_dir3d_t direction);
+
+/// @brief Turns the snake left relative to its current direction and roof.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_turn_left(snaken3d_t* snaken);
+
+/// @brief Turns the snake right relative to its current direction and roof.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_turn_right(snaken3d_t* snaken);
+
+/// @brief Turns the snake towards its roof.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_turn_up(snaken3d_t* snaken);
+
+/// @brief Turns the snake away from its roof.
+/// @param snaken The snaken to apply the turn to.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_turn_down(snaken3d_t* snaken);
+
+/// @brief Sets the snake view radius.
+/// @param snaken The snaken to apply the snake view radius to.
+/// @param radius The radius to set the snake.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_snake_view_radius(snaken3d_t* snaken, snaken_world_size_t radius);
+
+/// @brief Sets the snake length, placing any new body pieces on the tail.
+/// @param snaken The snaken to apply the snake length to.
+/// @param length The new snake length.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_snake_length(snaken3d_t* snaken, snaken_world_size_t length);
+
+/// @brief Sets whether the snake can self-intersect without dying or not.
+/// @param snaken The snaken to apply changes to.
+/// @param val The value to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_self_intersect(snaken3d_t* snaken, snaken_bool_t val);
+
+/// @brief Sets the snake speed in the provided snaken.
+/// @param snaken The snaken to apply the new speed to.
+/// @param speed The new speed to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_snake_speed(snaken3d_t* snaken, snaken_snake_speed_t speed);
+
+/// @brief Sets the snake stamina in the provided snaken.
+/// @param snaken The snaken to apply the new stamina to.
+/// @param stamina The new stamina to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_snake_stamina(snaken3d_t* snaken, snaken_snake_stamina_t stamina);
+
+/// @brief Reseeds the apple locations generator of the provided snaken and respawns all apples from it.
+/// The same seed on the same configuration always yields the same apples.
+/// @param snaken The snaken to reseed.
+/// @param seed The seed to apply.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_seed(snaken3d_t* snaken, uint64_t seed);
+
+/// @brief Sets the provided snaken world to have [apples_count] apples at any time step.
+/// @param snaken The snaken to apply changes to.
+/// @param apples_count The amount of apples to be present at any time in the snaken world.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_set_apples_count(snaken3d_t* snaken, snaken_world_size_t apples_count);
+
+/// @brief Updates the location of the apple at the provided index, avoiding walls and other apples.
+/// The apple is left out, with a -1 location, if no cell is free.
+/// @param snaken The snaken to apply changes to.
+/// @param index The index of the apple to update.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_spawn_apple(snaken3d_t* snaken, snaken_world_size_t index);
+
+/// @brief Adds the provided walls to the existing walls in the provided snaken's world, skipping duplicates.
+/// @param snaken The snaken to apply walls to.
+/// @param walls_length The length of the walls array to add.
+/// @param walls The array of walls to add, as IDX3D locations. Ownership stays with the caller.
+/// @return The code for the occurred error, [SNAKEN_ERROR_NONE] if none.
+snaken_error_code_t snaken3d_add_walls(snaken3d_t* snaken, snaken_world_size_t walls_length, snaken_world_size_t* walls);
+
+// ##########################################
+// ##########################################
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,4 +2,21 @@
 
 double lerp(double a, double b, double t) {
     return a + t * (b - a);
-}
\ No newline at end of file
+}
+
+uint64_t snaken_rng_next(snaken_rng_t* rng) {
+    uint64_t z = ((*rng) += 0x9E3779B97F4A7C15u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+    return z ^ (z >> 31);
+}
+
+uint32_t snaken_rng_range(snaken_rng_t* rng, uint32_t n) {
+    // Multiply-shift maps the high bits onto the range without a division.
+    return (uint32_t) (((snaken_rng_next(rng) >> 32) * (uint64_t) n) >> 32);
+}
+
+float snaken_rng_float(snaken_rng_t* rng) {
+    // Use the top 24 bits, which is all a float mantissa can hold.
+    return (float) (snaken_rng_next(rng) >> 40) / (float) (1u << 24);
+}
@@ -1,6 +1,35 @@
 #ifndef __SNAKEN_UTILS__
 #define __SNAKEN_UTILS__
 
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// State of a seeded pseudo-random generator, independent from the global rand() state.
+typedef uint64_t snaken_rng_t;
+
 double lerp(double a, double b, double t);
 
+/// @brief Advances the provided generator and returns its next 64 random bits (splitmix64).
+/// @param rng The generator to advance.
+/// @return The generated bits.
+uint64_t snaken_rng_next(snaken_rng_t* rng);
+
+/// @brief Generates a random integer in [0, n) from the provided generator.
+/// @param rng The generator to advance.
+/// @param n The exclusive upper bound, greater than 0.
+/// @return The generated integer.
+uint32_t snaken_rng_range(snaken_rng_t* rng, uint32_t n);
+
+/// @brief Generates a random float in [0, 1) from the provided generator.
+/// @param rng The generator to advance.
+/// @return The generated float.
+float snaken_rng_float(snaken_rng_t* rng);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif